@@ -1,5 +1,11 @@
 #include "learn_colors_audio.h"
 #include "learn_colors.h"
+#include "learn_colors_profiler.h"
+#include "learn_colors_replay.h"
+#include "learn_colors_sweep.h"
+#include "learn_colors_analytics.h"
+#include "learn_colors_capture.h"
+#include "learn_colors_hotreload.h"
 
 const int INITIAL_SCREEN_WIDTH = 2880 / 3;
 const int INITIAL_SCREEN_HEIGHT = 1920 / 3;
@@ -57,12 +63,27 @@ int compareTrays(const void* a, const void* b) {
     return 0;
 }
 
+// Analytics
+void logCardEvent(const Game *game, EventType type, int cardIndex, int trayIndex, bool hit, float reaction) {
+    const Card *card = &game->cards[cardIndex];
+    AnalyticsPush((Event) {
+        .time = GetTime(),
+        .reaction = reaction,
+        .colorId = card->colorId,
+        .score = game->score,
+        .type = type,
+        .hit = hit,
+        .card = cardIndex,
+        .tray = trayIndex,
+        .r = card->color.r,
+        .g = card->color.g,
+        .b = card->color.b,
+        .level = game->levelIndex
+    });
+}
+
 // Input
 void handleInput(Game *game, float scale) {
-    Tray *trays = game->trays;
-    Card *cards = game->cards;
-    Color *colors = game->colors;
-    Animation *stars = game->stars;
 #ifdef PLATFORM_WEB
 #else
     if (IsKeyPressed(KEY_F)) {
@@ -80,173 +101,237 @@ void handleInput(Game *game, float scale) {
         }
     }
 #endif
-    if (IsKeyPressed(KEY_R)) {
+    // Re-deals and level switches draw from the RNG, they are recorded with the pointers below
+    unsigned int keys = ReplayKeys((IsKeyPressed(KEY_R) ? REPLAY_DEAL : 0)
+        | (IsKeyPressed(KEY_PAGE_DOWN) ? REPLAY_NEXT : 0)
+        | (IsKeyPressed(KEY_PAGE_UP) ? REPLAY_PREVIOUS : 0));
+    if (keys & REPLAY_DEAL) {
         reset(&game->score);
         initCards(game);
     }
+    if (keys & (REPLAY_NEXT | REPLAY_PREVIOUS)) {
+        reset(&game->score);
+        setLevel(game, game->levelIndex + ((keys & REPLAY_NEXT) ? 1 : -1));
+        printf("%-14s: %d %s\n", "level", game->levelIndex, game->level->name);
+    }
+    if (IsKeyPressed(KEY_P)) {
+        ProfilePrint();
+        PacerPrint();
+        AssetsPrint();
+    }
+    if (!sweep.isRunning) {
+        HandlePresentationKeys();
+    }
 
 
-    // Update virtual mouse (clamped mouse value behind game screen)
-    // Vector2 mouse = GetMousePosition();
-    // Vector2 touchPosition = GetTouchPosition(0);
+    // Every finger, recorded or replayed from here on, so a replay drives the exact same logic
+    PointerFrame frame = ReplayPointers(ReadPointers(scale, screenWidth, screenHeight, gameScreenWidth, gameScreenHeight));
 
-    Vector2 mouse = GetTouchPosition(0);
-    Vector2 virtualMouse = { 0 };
-    virtualMouse.x = (mouse.x - (screenWidth - (gameScreenWidth*scale))*0.5f)/scale;
-    virtualMouse.y = (mouse.y - (screenHeight - (gameScreenHeight*scale))*0.5f)/scale;
-    virtualMouse = Vector2Clamp(virtualMouse, (Vector2){ 0, 0 }, (Vector2){ (float)gameScreenWidth, (float)gameScreenHeight });
+    game->virtualMouse = frame.hover;
+    game->isPointerDown = false;
+    for (int i = 0; i < frame.count; ++i) {
+        if (frame.pointers[i].down) game->isPointerDown = true;
+    }
 
-    game->virtualMouse = virtualMouse;
+    handlePointers(game, &frame);
+}
+void buildHitGrid(Game *game) {
+    HitGridClear(&game->grid);
+    for (int j = 0; j < game->noOfCards; ++j) HitGridAdd(game->grid.cards, game->cards[j].dest, j);
+    for (int j = 0; j < game->noOfTrays; ++j) HitGridAdd(game->grid.trays, game->trays[j].dest, j);
+}
+void handlePointers(Game *game, const PointerFrame *frame) {
+    bool isGridBuilt = false;
 
-    // Handle Tray
-    for (int i = 0; i < NO_OF_TRAYS; ++i) {
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+    for (int i = 0; i < frame->count; ++i) {
+        const Pointer *pointer = &frame->pointers[i];
+
+        // Cards and trays move between frames, bin them again only when something needs a lookup
+        if ((pointer->pressed || pointer->released) && !isGridBuilt) {
+            buildHitGrid(game);
+            isGridBuilt = true;
         }
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+
+        if (pointer->pressed) {
+            grabCard(game, pointer);
         }
-        if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
-            // colors[i] = original[i];
+
+        int drag = -1;
+        for (int j = 0; j < game->noOfDrags; ++j) {
+            if (game->drags[j].id == pointer->id) drag = j;
         }
-    }
+        if (drag < 0) continue;
 
-    // Handle Cards
-    for (int i = 0; i < NO_OF_CARDS; ++i) {
-        // Pointer arithmetic to get the next card
-        Card *card = (cards + i);
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-            if (CheckCollisionPointRec(virtualMouse, card->dest)) {
-                card->isDragging = true;
-            }
+        Card *card = &game->cards[game->drags[drag].card];
+        if (pointer->down) {
+            card->dest.x = pointer->position.x - card->dest.width / 2;
+            card->dest.y = pointer->position.y - card->dest.height / 2;
         }
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-            if (card->isDragging) {
-                card->dest.x = virtualMouse.x - card->dest.width / 2;
-                card->dest.y = virtualMouse.y - card->dest.height / 2;
-            }
+        if (pointer->released) {
+            int cardIndex = game->drags[drag].card;
+            game->drags[drag] = game->drags[--game->noOfDrags];
+            dropCard(game, cardIndex, pointer->position);
         }
-        if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
-
-            if (card->isDragging) {
-                card->isDragging = false;
-
-                bool hit = false;
-                int sum = 0;
-
-                Tray *tray;
-                for (int j = 0; j < NO_OF_TRAYS; ++j) {
-                    tray = trays + j;
-                    if (CheckCollisionRecs(card->dest, tray->dest) && ColorIsEqual(card->color, colors[j])) {
-                        hit = true;
-                        ++(game->counter);
-                        break;
-                    }
-                }
+    }
+}
+void grabCard(Game *game, const Pointer *pointer) {
+    if (game->noOfDrags >= MAX_POINTERS) return;
 
-                // Did the card enter the correct tray?
-                if (hit) {
-                    // Well done, but has it already entered the zone?
-                    if (card->reachedTarget) continue;
-
-                    #if defined(DEBUG)
-                        printf("HIT %d\n", game->counter);
-                    #endif
-
-                    if (!card->scoredPoints) {
-                        ++(game->score);
-
-                        // Find a slot thats not animating and start animating
-                        for (int i = 0; i < NO_OF_STARS; ++i) {
-                            Animation *star = stars + i;
-                            if (!star->isAnimating) {
-                                star->position = (Vector2) { virtualMouse.x - star->texture->width / NO_FRAMES_STARS / 2, virtualMouse.y - star->texture->height / 2 };
-                                star->isAnimating = true;
-                                break;
-                            }
-                        }
-
-                        // Apply screen shake to the current Tray
-                        tray->isShaking = true;   // Shake for 0.5 seconds
-                        tray->shakeDuration = 0.10f;   // Shake for 0.5 seconds
-                        tray->shakeIntensity = 1.0f;  // Shake ny up to 10 pixels
-
-                        if (isAudio && !isOff) PlaySFX(sfx.click);
-                    }
-                    card->reachedTarget = true;
-                    card->scoredPoints = true;
-                } else {
-                    // No, tween the card back to its original position
-
-                    #if defined(DEBUG)
-                        printf("Reset Card...\n");
-                    #endif
-
-                    if (isTweenCard && !isOff) {
-                        card->state = TWEEN;
-                        card->currentPosition = (Vector2) { virtualMouse.x - card->dest.width / 2, virtualMouse.y - card->dest.height / 2 };
-                    } else {
-                        card->dest.x = card->targetPosition.x;
-                        card->dest.y = card->targetPosition.y;
-                    }
-
-                    if (isAudio && !isOff) PlaySFX(sfx.stop);
-                }
+    // Only the cards binned under the finger, minus the ones other fingers hold
+    unsigned int held = 0;
+    for (int j = 0; j < game->noOfDrags; ++j) {
+        held |= 1u << game->drags[j].card;
+    }
+    unsigned int candidates = HitGridPoint(game->grid.cards, pointer->position) & ~held;
 
-                // Have all cards been moved to the correct zone?
-                for (int j = 0; j < NO_OF_CARDS; ++j) {
-                    sum += cards[j].reachedTarget;
-                }
+    // Topmost first, cards are drawn in index order
+    for (int i = game->noOfCards - 1; i >= 0; --i) {
+        if (!(candidates & (1u << i))) continue;
 
-                // Yes? Reset cards
-                if (sum >= NO_OF_CARDS) {
-                    initCards(game);
+        Card *card = &game->cards[i];
+        if (!CheckCollisionPointRec(pointer->position, card->dest)) continue;
 
-                    if (isAudio && !isOff) PlaySFX(sfx.popup);
+        card->isDragging = true;
+        card->grabTime = GetTime();
+        game->drags[game->noOfDrags++] = (PointerDrag) { pointer->id, i };
+        logCardEvent(game, EVENT_GRAB, i, -1, false, card->grabTime - game->roundTime);
+        return;
+    }
+}
+void dropCard(Game *game, int cardIndex, Vector2 position) {
+    Card *card = &game->cards[cardIndex];
+    Card *cards = game->cards;
+    Animation *stars = game->stars;
+    card->isDragging = false;
+
+    bool hit = false;
+    int sum = 0;
+
+    int target = -1;
+    Tray *tray = NULL;
+    // Lowest tray first, like the full scan it replaces
+    unsigned int candidates = HitGridRect(game->grid.trays, card->dest);
+    while (candidates != 0) {
+        int j = __builtin_ctz(candidates);
+        candidates &= candidates - 1;
+
+        tray = &game->trays[j];
+        if (!CheckCollisionRecs(card->dest, tray->dest)) continue;
+
+        target = j;
+        // Close enough in CIEDE2000 for this level, one table lookup
+        if (ColorsMatch(&colorMatch, card->colorId, tray->colorId)) {
+            hit = true;
+            ++(game->counter);
+            break;
+        }
+    }
+    logCardEvent(game, EVENT_DROP, cardIndex, target, hit, GetTime() - card->grabTime);
+
+    // Did the card enter the correct tray?
+    if (hit) {
+        // Well done, but has it already entered the zone?
+        if (card->reachedTarget) return;
+
+        if (!card->scoredPoints) {
+            ++(game->score);
+
+            // Find a slot thats not animating and start animating
+            for (int i = 0; i < NO_OF_STARS && features.isAnimateStars; ++i) {
+                Animation *star = stars + i;
+                if (!star->isAnimating) {
+                    // Frame size from the texture, the sheet is fetched after initStars on the web
+                    star->sheet.srcRec.width = star->texture->width / NO_FRAMES_STARS;
+                    star->sheet.srcRec.height = star->texture->height;
+                    star->position = (Vector2) { position.x - star->texture->width / NO_FRAMES_STARS / 2, position.y - star->texture->height / 2 };
+                    star->isAnimating = true;
+                    break;
                 }
             }
 
+            // Apply screen shake to the current Tray
+            tray->isShaking = true;
+            tray->shakeDuration = tuning.shakeDuration;
+            tray->shakeIntensity = tuning.shakeIntensity;
+
+            if (features.isAudio) PlaySFX(sfx.click);
+        }
+        card->reachedTarget = true;
+        card->scoredPoints = true;
+    } else {
+        // No, tween the card back to its original position
+
+        if (features.isTweenCard) {
+            card->state = TWEEN;
+            card->currentPosition = (Vector2) { position.x - card->dest.width / 2, position.y - card->dest.height / 2 };
+        } else {
+            card->dest.x = card->targetPosition.x;
+            card->dest.y = card->targetPosition.y;
         }
+
+        if (features.isAudio) PlaySFX(sfx.stop);
+    }
+
+    // Have all cards been moved to the correct zone?
+    for (int j = 0; j < game->noOfCards; ++j) {
+        sum += cards[j].reachedTarget;
     }
 
+    // Yes? Reset cards
+    if (sum >= game->noOfCards) {
+        AnalyticsPush((Event) {
+            .time = GetTime(),
+            .reaction = GetTime() - game->roundTime,
+            .score = game->score,
+            .type = EVENT_ROUND,
+            .card = -1,
+            .tray = -1,
+            .level = game->levelIndex
+        });
+        initCards(game);
+        // A press later in this frame must see the new deal
+        buildHitGrid(game);
+
+        if (features.isAudio) PlaySFX(sfx.popup);
+    }
 }
 
 // Draw
 void drawBackground(Texture2D layers[], double *increment, int order[]) {
-    if (isDrawBackground && !isOff) {
-        (*increment) += (0.09) * GetFrameTime();
+    (*increment) += (0.09) * GetReplayFrameTime();
 
-        int width = layers[0].width;
-        int height = layers[0].height;
-        int startX = 0;
-        int startY = -height / 2 ;
+    int width = layers[0].width;
+    int height = layers[0].height;
+    int startX = 0;
+    int startY = -height / 2 ;
 
-        int row = 0;
+    int row = 0;
 
-        // For each layer on the y axis
-        while (startY < gameScreenHeight + height * 2) {
+    // For each layer on the y axis
+    while (startY < gameScreenHeight + height * 2) {
 
-            int index = order[row % 4];
-            int clampedW = (width - gameScreenWidth) / 2;
-            int speed = 0;
+        int index = order[row % 4];
+        int clampedW = (width - gameScreenWidth) / 2;
+        int speed = 0;
 
-            if (isPrarallaxBackground && !isOff) {
-                speed = (sin(*increment * index) * clampedW) + clampedW; // 0 < speed < 900
-            }
+        if (features.isPrarallaxBackground) {
+            speed = (sin(*increment * index) * clampedW) + clampedW; // 0 < speed < 900
+        }
 
-            int xPos = startX - speed;
+        int xPos = startX - speed;
 
-            DrawTexture(layers[index], xPos, startY, WHITE);
+        DrawTexture(layers[index], xPos, startY, WHITE);
 
-            startY += height / 1.6;
-            row++;
+        startY += height / 1.6;
+        row++;
 
-        }
     }
 }
-void drawCursor(Vector2 virtualMouse, Texture2D cursor, Texture2D cursorPressed) {
-    if (isShowCursor && IsCursorOnScreen() && !isOff) {
+void drawCursor(Vector2 virtualMouse, bool isPressed, Texture2D cursor, Texture2D cursorPressed) {
+    if (IsCursorOnScreen() || replay.mode == REPLAY_PLAY) {
         // Subtract the offset of cursor tip
         virtualMouse = Vector2SubtractValue(virtualMouse, 17);
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+        if (isPressed) {
             DrawTexture(cursorPressed, virtualMouse.x, virtualMouse.y, WHITE);
         } else {
             DrawTexture(cursor, virtualMouse.x, virtualMouse.y, WHITE);
@@ -262,6 +347,30 @@ void drawScore(int score) {
     DrawText((TextFormat("Score: %d", score)), 20, 20, 30, GRAY);
 }
 
+// Session
+void restartSession() {
+    // Same seed gives the same cards and clouds, so a replay lines up with its recording
+    if (replay.mode != REPLAY_OFF) SetRandomSeed(replay.seed);
+    ReplayRewind();
+
+    Game *game = ctx.game;
+    reset(&game->score);
+    game->counter = 0;
+    for (int i = 0; i < NO_OF_STARS; ++i) {
+        game->stars[i].isAnimating = false;
+        game->stars[i].sheet.currentFrame = 0;
+        game->stars[i].sheet.frameCounter = 0;
+        game->stars[i].sheet.srcRec.x = 0;
+    }
+    // A replay may switch levels, every pass starts where it was recorded
+    setLevel(game, replay.mode == REPLAY_PLAY ? replay.level : game->levelIndex);
+
+    ctx.increment = 0.0;
+    for (int i = 0; i < 20; i++) {
+        ctx.order[i] = GetRandomValue(0, 3);
+    }
+}
+
 // Stars
 void initStars(Animation *stars, Texture2D *starsTexture, Spritesheet starsSheet) {
     for (int i = 0; i < NO_OF_STARS; ++i) {
@@ -281,7 +390,7 @@ void updateStars(Animation *stars) {
         if (star->isAnimating) {
             star->sheet.frameCounter++;
             // Slow down frame speed
-            if (star->sheet.frameCounter >= (GetFPS() / star->sheet.frameSpeed)) {
+            if (star->sheet.frameCounter >= (GetReplayFPS() / star->sheet.frameSpeed)) {
                 // Time to update current frame index and reset counter
                 star->sheet.frameCounter = 0;
                 star->sheet.currentFrame++;
@@ -305,7 +414,7 @@ void drawStars(Animation *stars) {
     for (int i = 0; i < NO_OF_STARS; ++i) {
 
         Animation *star = stars + i;
-        if (star->isAnimating && isAnimateStars && !isOff) {
+        if (star->isAnimating) {
             DrawTextureRec(*(star->texture), star->sheet.srcRec, star->position , WHITE);
         }
     }
@@ -314,21 +423,18 @@ void drawStars(Animation *stars) {
 // Trays
 void initTrays(Game *game) {
     Tray *trays = game->trays;
-    Color *colors = game->colors;
+    const Level *level = game->level;
     Texture2D *texture = game->trayTexture;
 
-    int trayStartX = -(TRAY_WIDTH * NO_OF_TRAYS) / 2;
-    for (int i = 0; i < NO_OF_TRAYS; ++i) {
-        Rectangle dest = {
-            trayStartX + gameScreenWidth / 2 + (TRAY_WIDTH * i) + (i * GAP) - (GAP * (NO_OF_TRAYS - 1)) / 2,
-            gameScreenHeight - TRAY_HEIGHT - PADDING,
-            TRAY_WIDTH,
-            TRAY_HEIGHT
-        };
+    for (int i = 0; i < game->noOfTrays; ++i) {
+        // Layout was computed when the level cache was compiled
+        Rectangle dest = level->trayRects[i];
+        int colorId = level->trayColors[i];
 
         trays[i] = (Tray) {
             .texture = texture,
-            .color = colors[i],
+            .color = level->palette[colorId],
+            .colorId = colorId,
             .dest = dest,
             .isShaking = false,
             .shakeDuration = 0.0f,
@@ -337,8 +443,8 @@ void initTrays(Game *game) {
         };
     }
 }
-void updateTrays(Tray *trays) {
-    for (int i = 0; i < NO_OF_TRAYS; ++i) {
+void updateTrays(Tray *trays, int count) {
+    for (int i = 0; i < count; ++i) {
         // Tray *tray = (game->trays + i);
         Tray *tray = &trays[i];
         if (tray->isShaking) {
@@ -346,42 +452,46 @@ void updateTrays(Tray *trays) {
         }
     }
 }
-void drawTrays(Tray trays[]) {
-    for (int i = 0; i < NO_OF_TRAYS; ++i) {
-        Tray tray = trays[i];
-        if (isDrawTray && !isOff) {
+void drawTrays(Tray trays[], int count) {
+    // Branch once per frame, not once per tray
+    if (features.isDrawTray) {
+        for (int i = 0; i < count; ++i) {
+            Tray tray = trays[i];
+            Rectangle source = { 0, 0, tray.texture->width, tray.texture->height };
+            Rectangle shadow = { tray.dest.x - 7, tray.dest.y + 7, tray.dest.width, tray.dest.height };
             // DrawRectangleRounded(trays[i], 0.3f, 16, colors[i]);    // Show bounds
-            DrawTextureV(*trays->texture, (Vector2){tray.dest.x - 7, tray.dest.y + 7}, BLACK);
-            DrawTextureV(*trays->texture, (Vector2){tray.dest.x, tray.dest.y}, tray.color);
-        } else {
-            DrawRectangleRounded(trays[i].dest, 0.3f, 16, tray.color);
+            DrawTexturePro(*tray.texture, source, shadow, (Vector2) { 0 }, 0, BLACK);
+            DrawTexturePro(*tray.texture, source, tray.dest, (Vector2) { 0 }, 0, tray.color);
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            DrawRectangleRounded(trays[i].dest, 0.3f, 16, trays[i].color);
         }
     }
 }
 
 // Cards
+float tweenDuration(const Level *level) {
+    return tuning.tweenDuration > 0.0f ? tuning.tweenDuration : level->tweenDuration;
+}
 void initCards(Game *game) {
     Card *cards = game->cards;
-    Color *colors = game->colors;
-    Texture2D *textures = game->cardTextures;
-
-    int cardStartX = -(CARD_WIDTH * NO_OF_CARDS) / 2;
-    for (int i = 0; i < NO_OF_CARDS; ++i) {
-        Vector2 startPosition = {
-            cardStartX + gameScreenWidth / 2 + (CARD_WIDTH * i) + (i * GAP) - (GAP * (NO_OF_CARDS - 1)) / 2,
-            PADDING
-        };
-        int id = GetRandomValue(0, NO_OF_TRAYS - 1);
+    const Level *level = game->level;
+    Texture2D *textures = game->spriteTextures;
 
-        if (isDrawCard && id >= 3) id = GetRandomValue(0, 2);
+    // A fresh deal lets go of every held card
+    game->roundTime = GetTime();
+    game->noOfDrags = 0;
+    for (int i = 0; i < game->noOfCards; ++i) {
+        Vector2 startPosition = { level->cardRects[i].x, level->cardRects[i].y };
 
-        cards[i].dest = (Rectangle) {
-            startPosition.x,
-            startPosition.y,
-            CARD_WIDTH,
-            CARD_HEIGHT
-        };
-        cards[i].color = colors[id];
+        // Compiling the level checked every card color lands in some tray
+        int id = level->cardColors[GetRandomValue(0, level->noOfCardColors - 1)];
+        int sprite = level->sprites[id];
+
+        cards[i].dest = level->cardRects[i];
+        cards[i].color = level->palette[id];
+        cards[i].colorId = id;
 
         // flags
         cards[i].isDragging = false;
@@ -393,21 +503,71 @@ void initCards(Game *game) {
         cards[i].targetPosition = startPosition;
         cards[i].state = IDLE;
         cards[i].frameCounter = 0;
-        cards[i].duration = 30.0f;                  // Length in frame (30 frame = 500ms)
+        cards[i].duration = tweenDuration(level);   // Length in frame (30 frame = 500ms)
 
-        // img
+        // img, palette entries without a sprite draw as a flat card
         cards[i].nPatchTexture = game->nPatchTexture;
         cards[i].nPatchSrc = game->nPatchSrc;
-        cards[i].imgTexture = textures[id];
+        cards[i].imgTexture = sprite >= 0 ? textures[sprite] : (Texture2D) { 0 };
         cards[i].imgSrc = getRandomSource();
     }
 }
-void updateCards(Card cards[]) {
+
+// --watch. Tuning applies to the round in play, cards and stars pick up the size of a reloaded texture.
+void applyReload(Game *game, int changes) {
+    if (changes & RELOAD_TUNING) {
+        for (int i = 0; i < game->noOfCards; ++i) {
+            game->cards[i].duration = tweenDuration(game->level);
+        }
+        for (int i = 0; i < NO_OF_STARS; ++i) {
+            game->stars[i].sheet.frameSpeed = (int) tuning.starFrameSpeed;
+        }
+        TuningPrint();
+    }
+    if (changes & RELOAD_TEXTURE) {
+        for (int i = 0; i < game->noOfCards; ++i) {
+            Card *card = &game->cards[i];
+            int sprite = game->level->sprites[card->colorId];
+            card->nPatchTexture = game->nPatchTexture;
+            card->imgTexture = sprite >= 0 ? game->spriteTextures[sprite] : (Texture2D) { 0 };
+        }
+        for (int i = 0; i < NO_OF_STARS; ++i) {
+            Animation *star = &game->stars[i];
+            star->sheet.srcRec.width = star->texture->width / NO_FRAMES_STARS;
+            star->sheet.srcRec.height = star->texture->height;
+        }
+    }
+}
+void setLevel(Game *game, int index) {
+    // Layout is precomputed in the cache, switching is a pointer swap and a re-deal.
+    // The distance table is only rebuilt for a new palette.
+    game->levelIndex = ((index % levelCache.noOfLevels) + levelCache.noOfLevels) % levelCache.noOfLevels;
+    game->level = &levelCache.levels[game->levelIndex];
+    game->noOfTrays = game->level->noOfTrays;
+    game->noOfCards = game->level->noOfCards;
+    if (colorMatch.palette != game->level->palette) {
+        BuildColorMatch(&colorMatch, game->level->palette, game->level->noOfColors, game->level->tolerance);
+    }
+    initTrays(game);
+    initCards(game);
+}
+void updateCards(Card cards[], int count) {
     /**
      * Card cards[] is interpreted as Card *card
      */
-    if (isTweenCard && !isOff) {
-        for (int i = 0; i < NO_OF_CARDS; ++i) {
+    if (!features.isTweenCard) {
+        // Tweening was switched off mid flight, land the card
+        for (int i = 0; i < count; ++i) {
+            Card *card = (cards + i);
+            if (card->state == TWEEN) {
+                card->frameCounter = 0;
+                card->state = IDLE;
+                card->dest.x = card->targetPosition.x;
+                card->dest.y = card->targetPosition.y;
+            }
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
             Card *card = (cards + i);
             // Card *card = &cards[i];
             if (card->state == TWEEN) {
@@ -440,10 +600,10 @@ void updateCards(Card cards[]) {
         }
     }
 }
-void drawCards(Card cards[], Texture2D check) {
-    for (int i = 0; i < NO_OF_CARDS; ++i) {
+void drawCards(Card cards[], int count, Texture2D check) {
+    for (int i = 0; i < count; ++i) {
         Card card = cards[i];
-        if (isDrawCard && !isOff) {
+        if (features.isDrawCard && card.imgTexture.id > 0) {
             DrawTextureNPatch(card.nPatchTexture, card.nPatchSrc, card.dest, (Vector2) { 0 }, 0, WHITE);
             DrawTexturePro(card.imgTexture, card.imgSrc, card.dest, (Vector2) { 0 }, 0, WHITE);
             // DrawRectangleRoundedLinesEx(card.dest, 0.3f, 16, 6, ColorAlpha(PINK, 0.5f));
@@ -454,9 +614,9 @@ void drawCards(Card cards[], Texture2D check) {
 
         // Draw empty square
         if (card.reachedTarget) {
-            int x = (card.targetPosition.x + CARD_WIDTH / 2) - check.width / 2;
-            int y = (card.targetPosition.y + CARD_HEIGHT / 2) - check.height / 2;
-            DrawRectangleLines(card.targetPosition.x, card.targetPosition.y, CARD_WIDTH, CARD_HEIGHT, ColorAlpha(GRAY, 0.4f));
+            int x = (card.targetPosition.x + card.dest.width / 2) - check.width / 2;
+            int y = (card.targetPosition.y + card.dest.height / 2) - check.height / 2;
+            DrawRectangleLines(card.targetPosition.x, card.targetPosition.y, card.dest.width, card.dest.height, ColorAlpha(GRAY, 0.4f));
             DrawTexture(check, x, y, WHITE);
         }
     }
@@ -464,6 +624,13 @@ void drawCards(Card cards[], Texture2D check) {
 
 
 void GameLoop() {
+        ProfileBegin(PROFILE_FRAME);
+
+        // Features are picked once here, everything below only reads `features`
+        ResolvePresentation();
+        UpdateSFX(features.isAudio);
+        if (hotReload.isWatching) applyReload(ctx.game, HotReloadPoll());
+
         // Compute required framebuffer scaling
         float scale = MIN((float) screenWidth / gameScreenWidth, (float )screenHeight / gameScreenHeight);
 
@@ -482,25 +649,38 @@ void GameLoop() {
         #endif
 
         // Input
+        ProfileBegin(PROFILE_INPUT);
         handleInput(ctx.game, scale);
+        ProfileEnd(PROFILE_INPUT);
 
         // Update
-        updateCards(ctx.game->cards);
-        updateTrays(ctx.game->trays);
+        ProfileBegin(PROFILE_UPDATE);
+        updateCards(ctx.game->cards, ctx.game->noOfCards);
+        updateTrays(ctx.game->trays, ctx.game->noOfTrays);
         updateStars(ctx.game->stars);
+        ProfileEnd(PROFILE_UPDATE);
 
         // Draw to texture
+        ProfileBegin(PROFILE_DRAW);
         BeginTextureMode(ctx.target);
             ClearBackground(WHITE);
-            drawBackground(ctx.cloudsTexture, &ctx.increment, ctx.order);
-            drawTrays(ctx.game->trays);
-            drawCards(ctx.game->cards, ctx.checkTexture);
-            drawCursor(ctx.game->virtualMouse, ctx.cursorTexture, ctx.cursorPressedTexture);
+            if (features.isDrawBackground) drawBackground(ctx.cloudsTexture, &ctx.increment, ctx.order);
+            drawTrays(ctx.game->trays, ctx.game->noOfTrays);
+            drawCards(ctx.game->cards, ctx.game->noOfCards, ctx.checkTexture);
+            if (features.isShowCursor) drawCursor(ctx.game->virtualMouse, ctx.game->isPointerDown, ctx.cursorTexture, ctx.cursorPressedTexture);
             drawScore(ctx.game->score);
-            drawStars(ctx.game->stars);
+            if (features.isAnimateStars) drawStars(ctx.game->stars);
             DrawRectangleLinesEx((Rectangle){0,0,screenWidth,screenHeight}, 1, Fade(BLACK, 0.2));
-            DrawFPS(gameScreenWidth - MeasureText("60 FPS", 20) - 20, 20);
+            // A replay's frame rate is synthetic, leaving it out keeps replayed frames identical
+            if (replay.mode != REPLAY_PLAY) DrawFPS(gameScreenWidth - MeasureText("60 FPS", 20) - 20, 20);
         EndTextureMode();
+        ProfileEnd(PROFILE_DRAW);
+
+        if (capture.isOpen) {
+            ProfileBegin(PROFILE_CAPTURE);
+            CaptureFrame(ctx.target);
+            ProfileEnd(PROFILE_CAPTURE);
+        }
 
 
         // Draw to screen
@@ -511,6 +691,7 @@ void GameLoop() {
         Vector2 origin = { 0, 0 };
         float rotation = 0.0f;
 
+        ProfileBegin(PROFILE_PRESENT);
         BeginDrawing();
         // BeginScissorMode(0, 0, GetScreenWidth(), 200);
             ClearBackground(BLACK);
@@ -518,20 +699,254 @@ void GameLoop() {
             DrawTexturePro(ctx.target.texture, renderSource, renderDest, origin, rotation, WHITE);
 
         // EndScissorMode();
+#if !defined(PLATFORM_WEB)
+            // Before the swap, EndDrawing polls input right after it so nothing waits out the sleep
+            ProfileBegin(PROFILE_WAIT);
+            PacerWait();
+            double wait = ProfileEnd(PROFILE_WAIT);
+            ProfileExclude(PROFILE_FRAME, wait);
+            ProfileExclude(PROFILE_PRESENT, wait);
+#endif
         EndDrawing();
+        ProfileEnd(PROFILE_PRESENT);
+
+        // No-op when the writer thread is running
+        AnalyticsFrame();
+
+        ProfileEnd(PROFILE_FRAME);
 }
 
-int main() {
+// --bench touch, every finger presses a card, drags it to a tray and lets go, staggered
+void benchTouch(int levelIndex, int fingers, int frames) {
+    // No window, so every texture is empty and cards deal flat
+    Texture2D starsTexture = { 0 };
+    Texture2D spriteTextures[MAX_SPRITES] = { 0 };
+    Animation stars[NO_OF_STARS];
+    initStars(stars, &starsTexture, (Spritesheet) { 0 });
+    Game game = { .levelIndex = levelIndex, .spriteTextures = spriteTextures, .stars = stars };
+    setLevel(&game, levelIndex);
+    features = (Presentation) { .isTweenCard = true, .isAnimateStars = true };
+
+    const int press = 0;        // Frame of the cycle each phase starts on
+    const int release = 20;
+    const int cycle = 30;
+    int events = 0;
+    double start = analyticsNow();
+
+    for (int f = 0; f < frames; ++f) {
+        PointerFrame frame = { 0 };
+        for (int i = 0; i < fingers && i < MAX_POINTERS; ++i) {
+            int t = f + i * 3;
+            int phase = t % cycle;
+            if (phase > release) continue;
+
+            // Finger i works card i and tray i, modulo the board, so fingers fight over cards
+            Rectangle from = game.level->cardRects[(i + t / cycle) % game.noOfCards];
+            Rectangle to = game.level->trayRects[(i + t / cycle) % game.noOfTrays];
+            float k = (float) (phase - press) / (release - press);
+            Vector2 position = {
+                Lerp(from.x + from.width / 2, to.x + to.width / 2, k),
+                Lerp(from.y + from.height / 2, to.y + to.height / 2, k)
+            };
+            frame.pointers[frame.count++] = (Pointer) {
+                .id = i,
+                .position = position,
+                .pressed = phase == press,
+                .down = phase != release,
+                .released = phase == release
+            };
+        }
+        events += frame.count;
+        handlePointers(&game, &frame);
+        updateCards(game.cards, game.noOfCards);
+    }
+    double total = analyticsNow() - start;
+
+    printf("%-14s: %d fingers, %d frames, level %d %s\n", "bench", fingers, frames, game.levelIndex, game.level->name);
+    printf("%-14s: %.1f ns/frame\n", "input", total / frames * 1e9);
+    printf("%-14s: %.1f ns/pointer\n", "pointer", total / MAX(events, 1) * 1e9);
+    printf("%-14s: %d\n", "hits", game.counter);
+    printf("%-14s: %d\n", "score", game.score);
+}
+
+#if defined(PLATFORM_WEB)
+void webFrame() {
+    if (!PacerReady()) return;
+    GameLoop();
+    AssetsFrame();
+}
+#endif
+
+int main(int argc, char *argv[]) {
 
     // Setup config
+    printf("-------------------\n");
+    printf("CONFIG\n");
+    printf("-------------------\n");
+    // --profile <file>     presentation flags, see resources/presentation.cfg
+    // --record <file>      record the session
+    // --replay <file>      play a recorded session back
+    // --sweep [frames]     measure every combination of features, then exit
+    // --level <n>          start on level n of resources/levels.json
+    // --compile-levels     rebuild resources/levels.bin, then exit
+    // --analytics <file>   log grabs, drops and rounds, .bin = binary, otherwise NDJSON
+    // --fps <n>            target frame rate, default 60 (vsync: the monitor's)
+    // --vsync              let the swap pace frames, only measure them
+    // --bench analytics    time the event log, then exit
+    // --bench touch        time 10 synthetic fingers on the --level board, then exit
+    // --capture <file> [frames]  hidden window, uncapped, every frame of ctx.target to .gif, .y4m or a PNG sequence
+    // --golden <dir> [frames]    same, compared against <dir>/frame_*.png, exits 1 on a mismatch
+    // --golden-update <dir> [frames]  write <dir>/frame_*.png
+    // --bench golden       time the image diff, then exit
+    // --bench match        time the CIEDE2000 table one pair at a time and batched, then exit
+    // --compress-audio <wav> <qoa>  mono QOA copy of a sound for the web build, then exit
+    // --watch              reload changed textures, sounds and resources/tuning.cfg while running
+    const char *profileFile = PRESENTATION_FILE;
+    const char *recordFile = NULL;
+    const char *replayFile = NULL;
+    bool isSweep = false;
+    int sweepFrames = 0;
+    int levelIndex = 0;
+    bool isCompileLevels = false;
+    const char *analyticsFile = NULL;
+    int targetFPS = 0;
+    bool isVsync = false;
+    bool isWatch = false;
+    const char *bench = NULL;
+    const char *captureFile = NULL;
+    CaptureFormat captureFormat = CAPTURE_PNG;
+    char goldenFile[256];
+    int captureFrames = 0;
+    const char *compressFiles[2] = { NULL, NULL };
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profileFile = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordFile = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayFile = argv[++i];
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            isSweep = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') sweepFrames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            levelIndex = atoi(argv[++i]);
+            if (levelIndex < 0 || levelIndex >= MAX_LEVELS) {
+                printf("--level %s: not a level, 0 to %d\n", argv[i], MAX_LEVELS - 1);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--compile-levels") == 0) {
+            isCompileLevels = true;
+        } else if (strcmp(argv[i], "--compress-audio") == 0 && i + 2 < argc) {
+            compressFiles[0] = argv[++i];
+            compressFiles[1] = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            targetFPS = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--vsync") == 0) {
+            isVsync = true;
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            isWatch = true;
+        } else if (strcmp(argv[i], "--analytics") == 0 && i + 1 < argc) {
+            analyticsFile = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            bench = argv[++i];
+        } else if ((strcmp(argv[i], "--capture") == 0 || strcmp(argv[i], "--golden") == 0 || strcmp(argv[i], "--golden-update") == 0) && i + 1 < argc) {
+            const char *option = argv[i];
+            captureFile = argv[++i];
+            if (strcmp(option, "--capture") == 0) captureFormat = CaptureFormatOf(captureFile);
+            else if (strcmp(option, "--golden") == 0) captureFormat = CAPTURE_GOLDEN;
+            else {
+                snprintf(goldenFile, sizeof(goldenFile), "%s/%s.png", captureFile, GOLDEN_NAME);
+                captureFile = goldenFile;
+            }
+            if (i + 1 < argc && argv[i + 1][0] != '-') captureFrames = atoi(argv[++i]);
+        } else {
+            printf("unknown option %s\n", argv[i]);
+        }
+    }
+
+    if (isCompileLevels) {
+#if defined(PLATFORM_WEB)
+        printf("--compile-levels needs the desktop build (cJSON)\n");
+        return 1;
+#else
+        bool isCompiled = CompileLevels(LEVEL_FILE, &levelCache, gameScreenWidth, gameScreenHeight)
+            && SaveLevelCache(LEVEL_CACHE_FILE, &levelCache);
+        printf("%-14s: %s -> %s %s\n", "compiled", LEVEL_FILE, LEVEL_CACHE_FILE, isCompiled ? "" : "FAILED");
+        return isCompiled ? 0 : 1;
+#endif
+    }
+
+    if (compressFiles[0] != NULL) {
+        bool isCompressed = CompressSound(compressFiles[0], compressFiles[1]);
+        printf("%-14s: %s -> %s %s\n", "compressed", compressFiles[0], compressFiles[1], isCompressed ? "" : "FAILED");
+        return isCompressed ? 0 : 1;
+    }
+
+    if (bench != NULL) {
+        if (strcmp(bench, "analytics") == 0) {
+            AnalyticsBench("analytics_bench.ndjson", 1000000);
+            AnalyticsBench("analytics_bench.bin", 1000000);
+        } else if (strcmp(bench, "touch") == 0) {
+            LoadLevels(gameScreenWidth, gameScreenHeight);
+            benchTouch(levelIndex, MAX_POINTERS, 1000000);
+        } else if (strcmp(bench, "golden") == 0) {
+            GoldenBench(gameScreenWidth, gameScreenHeight, 1000);
+        } else if (strcmp(bench, "match") == 0) {
+            MatchBench(MAX_PALETTE, 100);
+        } else {
+            printf("unknown bench %s\n", bench);
+            return 1;
+        }
+        return 0;
+    }
+
+    printf("%-14s: %s%s\n", "profile", profileFile, LoadPresentation(profileFile) ? "" : " (defaults)");
+    printf("%-14s: %s%s\n", "tuning", TUNING_FILE, LoadTuning(TUNING_FILE) ? "" : " (defaults)");
+    LoadLevels(gameScreenWidth, gameScreenHeight);
+    // --level was parsed before there was a count to check it against
+    if (levelIndex >= levelCache.noOfLevels) {
+        printf("--level %d: there are %d levels\n", levelIndex, levelCache.noOfLevels);
+        return 1;
+    }
+    if (replayFile != NULL && ReplayLoad(replayFile)) {
+        printf("%-14s: %s, %d frames\n", "replay", replayFile, replay.frameCount);
+        if (sweepFrames <= 0) sweepFrames = replay.frameCount - SWEEP_WARMUP_FRAMES;
+        levelIndex = replay.level;
+        if (levelIndex >= levelCache.noOfLevels) {
+            printf("%s: recorded on level %d, there are %d levels\n", replayFile, levelIndex, levelCache.noOfLevels);
+            return 1;
+        }
+        // Frames would differ for reasons the golden images cannot show
+        if (replay.config != ReplayConfig()) {
+            printf("%s: recorded with a different %s or %s\n", replayFile, TUNING_FILE, profileFile);
+            if (captureFile != NULL && captureFormat == CAPTURE_GOLDEN) return 1;
+        }
+    } else if (recordFile != NULL && ReplayRecord(recordFile, levelIndex)) {
+        printf("%-14s: %s\n", "record", recordFile);
+    }
+    // The capture window is hidden, without an end it would never close
+    if (captureFile != NULL && captureFrames <= 0 && replay.mode != REPLAY_PLAY) {
+        printf("--capture and --golden need --replay <file> or a frame count\n");
+        return 1;
+    }
+    if (isSweep) {
+        SweepBegin(sweepFrames);
+    }
+    if (analyticsFile != NULL) {
+        printf("%-14s: %s%s\n", "analytics", analyticsFile, AnalyticsOpen(analyticsFile) ? "" : " (could not open)");
+    }
+
     printf("-------------------\n");
     printf("INIT WINDOW\n");
     printf("-------------------\n");
 
     // SetConfigFlags( FLAG_WINDOW_UNDECORATED );
+    // Capturing renders off screen, the window is only there for the GL context
+    if (captureFile != NULL) SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    else if (isVsync) SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(screenWidth, screenHeight, "Learn Colors");
     SetMousePosition(-10, -10);
-    if (isShowCursor) {
+    if (presentation.isShowCursor) {
         // Cursor stuff not working :(
         // HideCursor();
         // DisableCursor();
@@ -548,22 +963,23 @@ int main() {
     // SetTextureFilter(target.texture, TEXTURE_FILTER_POINT);  // Texture scale filter to use
     SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);  // Texture scale filter to use
 
-    Texture2D checkTexture = LoadTexture("resources/sprites/check.png");
+    // The web package holds what the first screen draws, check and stars are fetched (see make web).
+    // Requested straight into the handles that draw them, a fetch or --watch fills them in place.
     Texture2D cloudsTexture[NO_OF_CLOUDS];
     for (int i = 0; i < NO_OF_CLOUDS; ++i) {
-        cloudsTexture[i] = LoadTexture(TextFormat("resources/backgrounds/clouds_%d.png", i + 1));
+        RequestTexture(&cloudsTexture[i], TextFormat("resources/backgrounds/clouds_%d.png", i + 1));
+    }
+    Texture2D trayTexture = { 0 };
+    Texture2D starsTexture = { 0 };
+    RequestTexture(&ctx.cursorTexture, "resources/ui/icon_hand_1.png");
+    RequestTexture(&ctx.cursorPressedTexture, "resources/ui/icon_hand_2.png");
+    RequestTexture(&trayTexture, "resources/sprites/tray.png");
+    RequestTexture(&starsTexture, "resources/ui/medal_stars.png");
+    RequestTexture(&ctx.checkTexture, "resources/sprites/check.png");
+    Texture2D spriteTextures[MAX_SPRITES] = { 0 };
+    for (int i = 0; i < levelCache.noOfSprites; ++i) {
+        RequestTexture(&spriteTextures[i], TextFormat("resources/sprites/%s.png", levelCache.spriteNames[i]));
     }
-    Texture2D cursorTexture = LoadTexture("resources/ui/icon_hand_1.png");
-    Texture2D cursorPressedTexture = LoadTexture("resources/ui/icon_hand_2.png");
-    Texture2D trayTexture = LoadTexture("resources/sprites/tray.png");
-    Texture2D starsTexture = LoadTexture("resources/ui/medal_stars.png");
-    Texture2D redTexture = LoadTexture("resources/sprites/red.png");
-    Texture2D greenTexture = LoadTexture("resources/sprites/green.png");
-    Texture2D blueTexture = LoadTexture("resources/sprites/blue.png");
-    Texture2D nPatchTexture = LoadTexture("resources/ui/ninepatch_button.png");
-
-    trayTexture.width = TRAY_WIDTH;
-    trayTexture.height = TRAY_HEIGHT;
 
     // Game vars
 
@@ -590,38 +1006,34 @@ int main() {
         .currentFrame = 0,
         .currentLine = 0,
         .frameCounter = 0,
-        .frameSpeed = 10
+        .frameSpeed = (int) tuning.starFrameSpeed
      };
 
     Animation stars[NO_OF_STARS];
 
     Game game = {
-        .colors = (Color[]) { RED, GREEN, BLUE, ORANGE, PINK, PURPLE, SKYBLUE, GRAY },
-        .cardTextures = (Texture2D[]) { redTexture, greenTexture, blueTexture },
+        .levelIndex = levelIndex,
+        .spriteTextures = spriteTextures,
         .trayTexture = &trayTexture,
         .frameCounter = 0,
         .score = 0,
         .counter = 0,
         .stars = stars,
-        .nPatchTexture = nPatchTexture,
         .nPatchSrc = srcInfo,
         .virtualMouse = { 0 }
      };
 
+    RequestTexture(&game.nPatchTexture, "resources/ui/ninepatch_button.png");
+
     // Rectangle trays[NO_OF_TRAYS];
     initStars(stars, &starsTexture, starsSheet);
-    initTrays(&game);
-    initCards(&game);
 
     double increment = 0.0;
 
-    int order[20];      // Random value used to displace the backgrounds velocity
-    for (int i = 0; i < 20; i++) {
-        order[i] = GetRandomValue(0, 3);
-    }
+    int order[20];      // Random value used to displace the backgrounds velocity, filled by restartSession
 
     // Audio
-    if (isAudio && !isOff) {
+    if (presentation.isAudio && !presentation.isOff) {
         printf("-------------------\n");
         printf("LOAD AUDIO\n");
         printf("-------------------\n");
@@ -634,49 +1046,87 @@ int main() {
     ctx.cloudsTexture = cloudsTexture;
     ctx.increment = increment;
     ctx.order = order;
-    ctx.checkTexture = checkTexture;
-    ctx.cursorTexture = cursorTexture;
-    ctx.cursorPressedTexture = cursorPressedTexture;
 
+    // Trays, cards and clouds
+    restartSession();
+
+    // A reload mid-session would not be in the recording
+    if (isWatch && replay.mode != REPLAY_OFF) {
+        printf("--watch is off while recording or replaying\n");
+    } else if (isWatch) {
+        printf("%-14s: resources, %s%s\n", "watch", TUNING_FILE, HotReloadOpen("resources", TUNING_FILE) ? "" : " (could not watch)");
+    }
+
+    bool isCaptureFailed = false;
+    if (captureFile != NULL) {
+        isCaptureFailed = !CaptureOpen(captureFile, captureFormat, gameScreenWidth, gameScreenHeight, captureFrames);
+        printf("%-14s: %s%s\n", "capture", captureFile, isCaptureFailed ? " (could not open)" : "");
+    }
 
     printf("-------------------\n");
     printf("GAME\n");
     printf("-------------------\n");
     // Main game loop
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(GameLoop, 0, 1);
+    // The browser already waits for the display, the pacer only drops ticks above the target rate
+    PacerBegin(PACER_VSYNC, targetFPS);
+    emscripten_set_main_loop(webFrame, 0, 1);
 #else
-    SetTargetFPS(60);
-    while (!WindowShouldClose()) {
+    // The sweep and capture run uncapped, they measure or record frames rather than pace them
+    PacerBegin(sweep.isRunning || capture.isOpen ? PACER_OFF : isVsync ? PACER_VSYNC : PACER_HYBRID, targetFPS);
+    while (!WindowShouldClose() && !isCaptureFailed) {
         GameLoop();
+
+        if (capture.isOpen && (CaptureFinished() || ReplayFinished())) break;
+
+        if (sweep.isRunning) {
+            if (SweepStep(profiler[PROFILE_FRAME].last)) restartSession();
+            if (!sweep.isRunning) break;
+        }
     }
 #endif
 
+    printf("-------------------\n");
+    printf("PROFILE\n");
+    printf("-------------------\n");
+    ProfilePrint();
+    PacerPrint();
+    if (isSweep && !sweep.isRunning) {
+        SweepPrint();
+    }
+    CaptureClose();
+    bool isGoldenPassed = GoldenClose();
+    ReplayClose();
+    AnalyticsClose();
+    HotReloadClose();
+
     printf("-------------------\n");
     printf("DESTROY\n");
     printf("-------------------\n");
 
     // Textures
     UnloadRenderTexture(target);
-    UnloadTexture(checkTexture);
+    UnloadTexture(ctx.checkTexture);
     for (int i = 0; i < NO_OF_CLOUDS; ++i) {
         UnloadTexture(cloudsTexture[i]);
     }
-    UnloadTexture(cursorTexture);
-    UnloadTexture(cursorPressedTexture);
+    UnloadTexture(ctx.cursorTexture);
+    UnloadTexture(ctx.cursorPressedTexture);
     UnloadTexture(trayTexture);
     UnloadTexture(starsTexture);
-    UnloadTexture(redTexture);
-    UnloadTexture(greenTexture);
-    UnloadTexture(blueTexture);
+    UnloadTexture(game.nPatchTexture);
+    for (int i = 0; i < levelCache.noOfSprites; ++i) {
+        UnloadTexture(spriteTextures[i]);
+    }
 
     // Audio
-    if (isAudio && !isOff) {
+    if (IsAudioDeviceReady()) {
         UnloadSFX();
     }
 
     CloseWindow();
 
 
-    return 0;
+    // Non-zero for CI when a golden frame did not match or the capture could not start
+    return isGoldenPassed && !isCaptureFailed ? 0 : 1;
 }
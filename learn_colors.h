@@ -14,8 +14,7 @@
     #include <emscripten/emscripten.h>
 #endif
 
-#define NO_OF_TRAYS 3
-#define NO_OF_CARDS 4
+// Board shape comes from the current level, these are the defaults
 #define GAP 70              // Space between cards & trays
 #define PADDING 70          // Space above & below
 
@@ -24,9 +23,10 @@
 #define NO_OF_STARS 4
 #define NO_FRAMES_STARS 8
 
+// Layout follows the compile-time defaults, toggling at runtime keeps the same bounds
 // https://gcc.gnu.org/onlinedocs/gcc-13.3.0/cpp/Defined.html - simplify
-// #if (defined(isDrawTray) && isDrawTray < 1)
-#if (isDrawTray < 1)
+// #if (defined(DEFAULT_DRAW_TRAY) && DEFAULT_DRAW_TRAY < 1)
+#if (DEFAULT_DRAW_TRAY < 1)
     // Size of tray without texture
     #define TRAY_WIDTH 150
     #define TRAY_HEIGHT 100
@@ -36,7 +36,7 @@
     #define TRAY_HEIGHT 183
 #endif
 
-#if (isDrawCard < 1)
+#if (DEFAULT_DRAW_CARD < 1)
     // Size of card without texture
     #define CARD_WIDTH 100
     #define CARD_HEIGHT 100
@@ -59,6 +59,9 @@
 #define MAX(a, b) ((a)>(b)? (a) : (b))
 #define MIN(a, b) ((a)<(b)? (a) : (b))
 
+#include "learn_colors_level.h"
+#include "learn_colors_touch.h"
+
 typedef enum {
     IDLE = 0,
     TWEEN,
@@ -82,9 +85,11 @@ typedef struct Animation {
 typedef struct Card {
     Rectangle dest;             // Actual position
     Color color;
+    int colorId;                // Index into the level palette
     bool isDragging;
     bool reachedTarget;
     bool scoredPoints;
+    double grabTime;            // GetTime() when the drag started
 
     // tween
     Vector2 currentPosition;    // Tween start position
@@ -103,6 +108,7 @@ typedef struct Card {
 typedef struct Tray {
     Texture2D *texture;
     Color color;
+    int colorId;                // Index into the level palette
     Rectangle dest;
     bool isShaking;
     float shakeDuration;     // Duration of the shake effect
@@ -111,18 +117,26 @@ typedef struct Tray {
 } Tray;
 
 typedef struct Game {
-    Card cards[NO_OF_CARDS];
-    Tray trays[NO_OF_TRAYS];
-    Color *colors;
-    Texture2D *cardTextures;
+    Card cards[MAX_CARDS];
+    Tray trays[MAX_TRAYS];
+    const Level *level;
+    int levelIndex;
+    int noOfCards;
+    int noOfTrays;
+    Texture2D *spriteTextures;  // levelCache.spriteNames
     Texture2D *trayTexture;
     Animation *stars;
     int frameCounter;
     int score;
     int counter;
+    double roundTime;           // GetTime() when the cards were dealt
     Texture2D nPatchTexture;
     NPatchInfo nPatchSrc;
     Vector2 virtualMouse;
+    bool isPointerDown;         // Any pointer
+    HitGrid grid;               // Rebuilt on frames with a press or release
+    PointerDrag drags[MAX_POINTERS];
+    int noOfDrags;
 } Game;
 
 typedef struct Context {
@@ -143,18 +157,26 @@ void applyShake(Tray *tray, float *elementX, float *elementY);
 int compareTrays(const void* a, const void* b);
 void initStars(Animation *stars, Texture2D *starsTexture, Spritesheet starsSheet);
 void initTrays(Game *game);
+float tweenDuration(const Level *level);
 void initCards(Game *game);
+void applyReload(Game *game, int changes);
+void setLevel(Game *game, int index);
 void handleInput(Game *game, float scale);
-void updateCards(Card cards[]);
-void updateTrays(Tray *trays);
+void buildHitGrid(Game *game);
+void handlePointers(Game *game, const PointerFrame *frame);
+void grabCard(Game *game, const Pointer *pointer);
+void dropCard(Game *game, int cardIndex, Vector2 position);
+void updateCards(Card cards[], int count);
+void updateTrays(Tray *trays, int count);
 void updateStars(Animation *stars);
 void drawBackground(Texture2D layers[], double *increment, int order[]);
-void drawTrays(Tray trays[]);
-void drawCards(Card cards[], Texture2D check);
-void drawCursor(Vector2 virtualMouse, Texture2D cursor, Texture2D cursorPressed);
+void drawTrays(Tray trays[], int count);
+void drawCards(Card cards[], int count, Texture2D check);
+void drawCursor(Vector2 virtualMouse, bool isPressed, Texture2D cursor, Texture2D cursorPressed);
 void drawScore(int score);
 void drawStars(Animation *stars);
 void reset(int *score);
+void restartSession(void);
 void GameLoop();
 
 #endif // LEARN_COLORS_H
@@ -0,0 +1,246 @@
+#ifndef LEARN_COLORS_ANALYTICS_
+#define LEARN_COLORS_ANALYTICS_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+#endif
+
+// --------------------
+#define ANALYTICS_RING_SIZE 4096        // Power of two
+#define ANALYTICS_MAX_BYTES (1 << 20)   // Rotate after 1 MB
+#define ANALYTICS_MAX_FILES 4           // file, file.1 .. file.3
+#define ANALYTICS_IDLE_NS 2000000       // Writer sleeps 2ms when the ring is empty
+#define ANALYTICS_MAGIC 0x4e564c4c      // "LLVN", binary log header
+#define ANALYTICS_VERSION 1
+// --------------------
+
+typedef enum {
+    EVENT_GRAB = 0,
+    EVENT_DROP,
+    EVENT_ROUND,
+} EventType;
+
+// 24 bytes, written as is by the binary format
+typedef struct Event {
+    double time;                // Seconds, GetTime()
+    float reaction;             // Grab: since the round was dealt, drop: since the grab, round: round length
+    unsigned short colorId;     // Palette index of the card
+    unsigned short score;
+    unsigned char type;         // EventType
+    unsigned char hit;
+    signed char card;
+    signed char tray;           // Tray the card was dropped on, -1 = none
+    unsigned char r;            // Card color
+    unsigned char g;
+    unsigned char b;
+    unsigned char level;
+} Event;
+
+// Single producer (game), single consumer (writer). Each index is stored by one side only.
+typedef struct EventRing {
+    Event events[ANALYTICS_RING_SIZE];
+    unsigned int head;          // Next slot to write, game thread
+    unsigned int cachedTail;    // Game side copy of tail, refreshed only when the ring looks full
+    unsigned int dropped;       // Events lost to a full ring, game thread
+    char padding[52];           // Keep tail off head's cache line
+    unsigned int tail;          // Next slot to read, writer thread
+} EventRing;
+
+typedef struct Analytics {
+    bool isOpen;
+    bool isBinary;              // .bin = Event structs, anything else = NDJSON
+    const char *fileName;
+    FILE *file;
+    long bytes;                 // Written to the current file
+    long long written;          // Events, all files
+    int running;                // Atomic, writer loop condition
+#if !defined(PLATFORM_WEB)
+    pthread_t thread;
+#endif
+} Analytics;
+
+EventRing eventRing = { 0 };
+Analytics analytics = { 0 };
+
+double analyticsNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Wait-free, a full ring drops the event instead of waiting on the writer
+bool AnalyticsPush(Event event) {
+    if (!analytics.isOpen) return false;
+
+    unsigned int head = eventRing.head;
+    if (head - eventRing.cachedTail >= ANALYTICS_RING_SIZE) {
+        eventRing.cachedTail = __atomic_load_n(&eventRing.tail, __ATOMIC_ACQUIRE);
+        if (head - eventRing.cachedTail >= ANALYTICS_RING_SIZE) {
+            ++eventRing.dropped;
+            return false;
+        }
+    }
+    eventRing.events[head & (ANALYTICS_RING_SIZE - 1)] = event;
+    __atomic_store_n(&eventRing.head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void analyticsHeader() {
+    if (analytics.isBinary) {
+        unsigned int header[3] = { ANALYTICS_MAGIC, ANALYTICS_VERSION, sizeof(Event) };
+        analytics.bytes += fwrite(header, 1, sizeof(header), analytics.file);
+    }
+}
+
+// file -> file.1 -> file.2 ..., the oldest falls off
+void analyticsRotate() {
+    fclose(analytics.file);
+    for (int i = ANALYTICS_MAX_FILES - 1; i > 0; --i) {
+        char from[256];
+        char to[256];
+        if (i == 1) snprintf(from, sizeof(from), "%s", analytics.fileName);
+        else snprintf(from, sizeof(from), "%s.%d", analytics.fileName, i - 1);
+        snprintf(to, sizeof(to), "%s.%d", analytics.fileName, i);
+        rename(from, to);
+    }
+    analytics.file = fopen(analytics.fileName, analytics.isBinary ? "wb" : "w");
+    analytics.bytes = 0;
+    if (analytics.file != NULL) analyticsHeader();
+}
+
+void analyticsWrite(const Event *event) {
+    if (analytics.file == NULL) return;
+
+    if (analytics.isBinary) {
+        analytics.bytes += fwrite(event, 1, sizeof(Event), analytics.file);
+    } else {
+        static const char *types[] = { "grab", "drop", "round" };
+        int n = fprintf(analytics.file,
+            "{\"t\":%.4f,\"type\":\"%s\",\"level\":%d,\"card\":%d,\"tray\":%d,\"hit\":%s,\"colorId\":%d,"
+            "\"color\":\"#%02x%02x%02x\",\"reaction\":%.4f,\"score\":%d}\n",
+            event->time, types[event->type], event->level, event->card, event->tray, event->hit ? "true" : "false",
+            event->colorId, event->r, event->g, event->b, event->reaction, event->score);
+        if (n > 0) analytics.bytes += n;
+    }
+    ++analytics.written;
+
+    if (analytics.bytes >= ANALYTICS_MAX_BYTES) analyticsRotate();
+}
+
+// Writer side, returns the number of events written
+int AnalyticsDrain() {
+    unsigned int tail = eventRing.tail;
+    unsigned int head = __atomic_load_n(&eventRing.head, __ATOMIC_ACQUIRE);
+    int count = (int) (head - tail);
+
+    for (; tail != head; ++tail) {
+        analyticsWrite(&eventRing.events[tail & (ANALYTICS_RING_SIZE - 1)]);
+    }
+    __atomic_store_n(&eventRing.tail, tail, __ATOMIC_RELEASE);
+    return count;
+}
+
+#if !defined(PLATFORM_WEB)
+void *analyticsWriter(void *arg) {
+    (void) arg;
+    struct timespec idle = { 0, ANALYTICS_IDLE_NS };
+    while (__atomic_load_n(&analytics.running, __ATOMIC_ACQUIRE)) {
+        if (AnalyticsDrain() == 0) {
+            fflush(analytics.file);
+            nanosleep(&idle, NULL);
+        }
+    }
+    AnalyticsDrain();
+    return NULL;
+}
+#endif
+
+bool AnalyticsOpen(const char *fileName) {
+    bool isBinary = IsFileExtension(fileName, ".bin");
+    analytics = (Analytics) {
+        .isBinary = isBinary,
+        .fileName = fileName,
+        .file = fopen(fileName, isBinary ? "wb" : "w")
+    };
+    if (analytics.file == NULL) return false;
+
+    eventRing.head = eventRing.tail = eventRing.cachedTail = eventRing.dropped = 0;
+    analyticsHeader();
+    analytics.isOpen = true;
+
+#if !defined(PLATFORM_WEB)
+    analytics.running = 1;
+    if (pthread_create(&analytics.thread, NULL, analyticsWriter, NULL) != 0) {
+        printf("%s: no writer thread, draining per frame\n", fileName);
+        analytics.running = 0;
+    }
+#endif
+    return true;
+}
+
+// Call once per frame after presenting, only does work when there is no writer thread
+void AnalyticsFrame() {
+    if (analytics.isOpen && !analytics.running) AnalyticsDrain();
+}
+
+void AnalyticsClose() {
+    if (!analytics.isOpen) return;
+
+#if !defined(PLATFORM_WEB)
+    if (analytics.running) {
+        __atomic_store_n(&analytics.running, 0, __ATOMIC_RELEASE);
+        pthread_join(analytics.thread, NULL);
+    }
+#endif
+    AnalyticsDrain();
+    if (analytics.file != NULL) fclose(analytics.file);
+    analytics.isOpen = false;
+    printf("%-14s: %lld events, %u dropped\n", "analytics", analytics.written, eventRing.dropped);
+}
+
+// --bench analytics, push cost per event and writer throughput
+void AnalyticsBench(const char *fileName, int count) {
+    if (!AnalyticsOpen(fileName)) {
+        printf("%s: could not open\n", fileName);
+        return;
+    }
+
+    Event event = { .type = EVENT_DROP, .hit = 1, .card = 2, .tray = 1, .r = 230, .g = 41, .b = 55, .reaction = 0.75f };
+    double pushing = 0.0;
+    double start = analyticsNow();
+
+    // Bursts of half the ring, like many frames worth of events, waiting for the writer between them
+    for (int pushed = 0; pushed < count; ) {
+        int burst = MIN(ANALYTICS_RING_SIZE / 2, count - pushed);
+        // Without a writer thread nobody else would empty the ring, drain it here like a frame would
+        AnalyticsFrame();
+        while (eventRing.head - __atomic_load_n(&eventRing.tail, __ATOMIC_ACQUIRE) > ANALYTICS_RING_SIZE / 2) {
+            // Spin, the writer is catching up
+        }
+        double t = analyticsNow();
+        for (int i = 0; i < burst; ++i) {
+            event.time = pushed + i;
+            AnalyticsPush(event);
+        }
+        pushing += analyticsNow() - t;
+        pushed += burst;
+    }
+    unsigned int dropped = eventRing.dropped;
+    bool isThreaded = analytics.running;
+    AnalyticsClose();
+    double total = analyticsNow() - start;
+
+    printf("%-14s: %d events -> %s%s\n", "bench", count, fileName, isThreaded ? "" : " (no writer thread, drained inline)");
+    printf("%-14s: %.1f ns/event\n", "push", pushing / count * 1e9);
+    printf("%-14s: %.0f events/s\n", "writer", count / total);
+    printf("%-14s: %u\n", "dropped", dropped);
+}
+
+#endif // LEARN_COLORS_ANALYTICS_
@@ -0,0 +1,138 @@
+#ifndef LEARN_COLORS_ASSETS_
+#define LEARN_COLORS_ASSETS_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+    #include <emscripten/heap.h>
+    #include <sys/stat.h>
+#endif
+
+// --------------------
+#define MAX_ASSETS 32
+#define MAX_ASSET_PATH 64
+// --------------------
+
+typedef enum {
+    ASSET_TEXTURE = 0,
+    ASSET_SOUND,
+} AssetType;
+
+// handle is where the game keeps the texture or sound, it is filled in place when the file arrives
+typedef struct Asset {
+    AssetType type;
+    char path[MAX_ASSET_PATH];
+    void *handle;               // Texture2D * or Sound *
+    bool isLoaded;
+} Asset;
+
+typedef struct Assets {
+    Asset assets[MAX_ASSETS];
+    int count;
+    int fetching;               // Requests in flight
+    int fetched;                // Arrived after startup
+    int failed;
+    int frames;
+} Assets;
+
+Assets assets = { 0 };
+
+void loadAsset(Asset *asset) {
+    if (asset->type == ASSET_TEXTURE) *(Texture2D *) asset->handle = LoadTexture(asset->path);
+    else *(Sound *) asset->handle = LoadSound(asset->path);
+    asset->isLoaded = true;
+}
+
+Asset *findAsset(const char *path) {
+    for (int i = 0; i < assets.count; ++i) {
+        if (strcmp(assets.assets[i].path, path) == 0) return &assets.assets[i];
+    }
+    return NULL;
+}
+
+#if defined(PLATFORM_WEB)
+// Everything the browser sent so far, page and package included. 0 when served from cache.
+EM_JS(double, webTransferBytes, (), {
+    var entries = performance.getEntriesByType('navigation').concat(performance.getEntriesByType('resource'));
+    var total = 0;
+    for (var i = 0; i < entries.length; ++i) total += entries[i].transferSize || 0;
+    return total;
+});
+
+// Memory only grows, the heap size is also its peak
+void assetsReport(const char *event) {
+    printf("%-14s: %.0f ms, %.0f KB transferred, %.1f MB heap\n", event,
+            emscripten_get_now(), webTransferBytes() / 1024.0, emscripten_get_heap_size() / (1024.0 * 1024.0));
+}
+
+// Callbacks run on the main thread between frames, GL and audio calls are fine here
+void assetFetched(const char *path) {
+    --assets.fetching;
+    ++assets.fetched;
+    Asset *asset = findAsset(path);
+    if (asset != NULL) loadAsset(asset);
+    if (assets.fetching == 0) assetsReport("assets fetched");
+}
+
+void assetFailed(const char *path) {
+    --assets.fetching;
+    ++assets.failed;
+    printf("%-14s: %s\n", "fetch failed", path);
+}
+#endif
+
+// Loads now when the file is on disk (desktop, or in the web package), otherwise fetches it next to the page.
+// Until then the handle stays zeroed, raylib draws and plays nothing for it.
+void requestAsset(AssetType type, const char *path, void *handle) {
+    Asset untracked;
+    Asset *asset = assets.count < MAX_ASSETS ? &assets.assets[assets.count++] : &untracked;
+    if (asset == &untracked) printf("%-14s: more than %d, %s is not tracked\n", "assets", MAX_ASSETS, path);
+    *asset = (Asset) { .type = type, .handle = handle };
+    strncpy(asset->path, path, MAX_ASSET_PATH - 1);
+
+#if defined(PLATFORM_WEB)
+    if (!FileExists(path)) {
+        // The package only made the directories it preloaded into
+        char dir[MAX_ASSET_PATH];
+        strcpy(dir, asset->path);
+        for (char *slash = strchr(dir, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+            *slash = '\0';
+            mkdir(dir, 0777);
+            *slash = '/';
+        }
+        ++assets.fetching;
+        emscripten_async_wget(asset->path, asset->path, assetFetched, assetFailed);
+        return;
+    }
+#endif
+    loadAsset(asset);
+}
+
+void RequestTexture(Texture2D *texture, const char *path) {
+    requestAsset(ASSET_TEXTURE, path, texture);
+}
+
+void RequestSound(Sound *sound, const char *path) {
+    requestAsset(ASSET_SOUND, path, sound);
+}
+
+// Call after each frame, the web build reports time to first frame, bytes and heap
+void AssetsFrame() {
+#if defined(PLATFORM_WEB)
+    if (assets.frames++ == 0) assetsReport("first frame");
+#endif
+}
+
+void AssetsPrint() {
+    printf("%-14s: %d tracked, %d fetched, %d in flight, %d failed\n", "assets", assets.count, assets.fetched, assets.fetching, assets.failed);
+#if defined(PLATFORM_WEB)
+    assetsReport("now");
+#endif
+}
+
+#endif // LEARN_COLORS_ASSETS_
@@ -2,9 +2,19 @@
 #define LEARN_COLORS_AUDIO_
 
 #include "raylib.h"
+#include "learn_colors_assets.h"
+
+#include <stdio.h>
+#include <stdbool.h>
 
 // --------------------
 #define MAX_SOUNDS 10
+#define SFX_RATE 22050              // Compressed copies are mono at this rate
+#if defined(PLATFORM_WEB)
+    #define SFX_FORMAT ".qoa"       // make web writes them next to the page, see CompressSound
+#else
+    #define SFX_FORMAT ".wav"
+#endif
 Sound soundArray[MAX_SOUNDS] = { 0 };
 int currentSound;
 // --------------------
@@ -18,17 +28,43 @@ typedef struct SFX {
 
 SFX sfx = { 0 };
 
+bool isAudioFailed = false;     // No device, not tried again until the feature is switched back on
+bool wasAudio = true;           // Feature state last frame, main has already tried at startup
+
 void LoadSFX() {
     InitAudioDevice();
-    
-    sfx.click = LoadSound("resources/sfx/button_click.wav");
-    sfx.select = LoadSound("resources/sfx/piece_select.wav");
-    sfx.stop = LoadSound("resources/sfx/piece_stop.wav");
-    sfx.popup = LoadSound("resources/sfx/popup.wav");
+    if (!IsAudioDeviceReady()) {
+        isAudioFailed = true;
+        printf("%-14s: no audio device, sounds off\n", "audio");
+        return;
+    }
+
+    // Fetched on the web, a sound plays once it has arrived
+    RequestSound(&sfx.click, "resources/sfx/button_click" SFX_FORMAT);
+    RequestSound(&sfx.select, "resources/sfx/piece_select" SFX_FORMAT);
+    RequestSound(&sfx.stop, "resources/sfx/piece_stop" SFX_FORMAT);
+    RequestSound(&sfx.popup, "resources/sfx/popup" SFX_FORMAT);
 
     currentSound = 0;
 }
 
+// Once a frame. Loads on first use, and retries a failed device only when the feature is turned back on.
+void UpdateSFX(bool isAudio) {
+    if (isAudio && !wasAudio) isAudioFailed = false;
+    wasAudio = isAudio;
+    if (isAudio && !isAudioFailed && !IsAudioDeviceReady()) LoadSFX();
+}
+
+// The WAVs are 24 bit stereo at 44.1kHz, QOA at 3.2 bits per sample brings them down about 30x
+bool CompressSound(const char *wavFile, const char *qoaFile) {
+    Wave wave = LoadWave(wavFile);
+    if (wave.data == NULL) return false;
+    WaveFormat(&wave, SFX_RATE, 16, 1);
+    bool isExported = ExportWave(wave, qoaFile);
+    UnloadWave(wave);
+    return isExported;
+}
+
 void PlaySFX(Sound sound) {
     PlaySound(sound);
 }
@@ -0,0 +1,462 @@
+#ifndef LEARN_COLORS_CAPTURE_
+#define LEARN_COLORS_CAPTURE_
+
+#include "raylib.h"
+#include "learn_colors_golden.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef enum {
+    CAPTURE_PNG = 0,            // file_00000.png, file_00001.png ...
+    CAPTURE_GIF,
+    CAPTURE_Y4M,                // Raw 4:2:0, e.g. ffmpeg -i file.y4m file.mp4
+    CAPTURE_GOLDEN,             // Compared against <dir>/frame_00000.png ..., nothing written unless a frame fails
+} CaptureFormat;
+
+// .gif, .y4m, anything else is a PNG sequence
+CaptureFormat CaptureFormatOf(const char *fileName) {
+    if (IsFileExtension(fileName, ".gif")) return CAPTURE_GIF;
+    if (IsFileExtension(fileName, ".y4m")) return CAPTURE_Y4M;
+    return CAPTURE_PNG;
+}
+
+#if defined(PLATFORM_WEB)
+
+// Readback needs desktop GL and threads, the web build only keeps the calls compiling
+typedef struct Capture {
+    bool isOpen;
+} Capture;
+
+Capture capture = { 0 };
+
+bool CaptureOpen(const char *fileName, CaptureFormat format, int width, int height, int limit) {
+    (void) format;
+    (void) width;
+    (void) height;
+    (void) limit;
+    printf("%s: capture needs the desktop build\n", fileName);
+    return false;
+}
+void CaptureFrame(RenderTexture2D target) {
+    (void) target;
+}
+bool CaptureFinished() {
+    return false;
+}
+void CaptureClose() {
+}
+
+#else
+
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <pthread.h>
+#include <time.h>
+
+// --------------------
+#define CAPTURE_PBOS 2                          // Read into one while mapping the other
+#define CAPTURE_WORKERS 4
+#define CAPTURE_SLOTS (CAPTURE_WORKERS * 2)     // Frames copied out of GL, waiting on or in a worker
+#define CAPTURE_FPS 60
+#define CAPTURE_GIF_STEP 2                      // GIF keeps every 2nd frame..
+#define CAPTURE_GIF_DELAY 3                     // ..shown for 3cs, GIF cannot do 1/30s exactly
+#define CAPTURE_LZW_HASH 8192                   // Power of two, > 4096 codes
+// --------------------
+
+typedef struct CaptureSlot {
+    int frame;                  // Output frame, -1 = free
+    bool isReady;               // Pixels copied, no worker has it yet
+    unsigned char *pixels;      // RGBA, bottom row first as GL reads it
+    unsigned char *indices;     // GIF, palette index per pixel
+    unsigned char *encoded;     // GIF image block, Y4M frame, flipped PNG pixels or golden heatmap
+    size_t size;
+} CaptureSlot;
+
+typedef struct Capture {
+    bool isOpen;
+    CaptureFormat format;
+    char fileName[256];         // PNG: without the extension, golden: the directory
+    FILE *file;                 // GIF and Y4M
+    int width;
+    int height;
+    int limit;                  // Game frames to capture, 0 = until the window closes or the replay ends
+    int frame;                  // Game frames seen
+    int read;                   // Output frames read back
+    unsigned int pbo[CAPTURE_PBOS];
+    CaptureSlot slots[CAPTURE_SLOTS];
+    int nextJob;                // Next output frame a worker takes
+    int nextWrite;              // Next output frame appended, GIF and Y4M are in order
+    bool isStopping;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;     // Any slot or counter above changed
+    pthread_t workers[CAPTURE_WORKERS];
+    double start;
+    double stall;               // Seconds the game waited for a free slot
+} Capture;
+
+Capture capture = { 0 };
+
+// 6 x 7 x 6 color cube, green gets the extra level. Index = gifR[r] + gifG[g] + gifB[b]
+unsigned char gifR[256];
+unsigned char gifG[256];
+unsigned char gifB[256];
+
+double captureNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+void captureWrite16(unsigned char *out, int value) {
+    out[0] = value & 0xff;
+    out[1] = (value >> 8) & 0xff;
+}
+
+void gifHeader() {
+    unsigned char header[13 + 256 * 3 + 19] = { 'G', 'I', 'F', '8', '9', 'a' };
+    captureWrite16(header + 6, capture.width);
+    captureWrite16(header + 8, capture.height);
+    header[10] = 0xf7;          // Global color table of 256, 8 bit
+    unsigned char *palette = header + 13;
+    for (int r = 0; r < 6; ++r) {
+        for (int g = 0; g < 7; ++g) {
+            for (int b = 0; b < 6; ++b) {
+                unsigned char *entry = palette + (r * 42 + g * 6 + b) * 3;
+                entry[0] = r * 255 / 5;
+                entry[1] = g * 255 / 6;
+                entry[2] = b * 255 / 5;
+            }
+        }
+    }
+    // Loop forever
+    static const unsigned char loop[19] = { 0x21, 0xff, 0x0b, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00 };
+    memcpy(palette + 256 * 3, loop, sizeof(loop));
+    fwrite(header, 1, sizeof(header), capture.file);
+
+    for (int i = 0; i < 256; ++i) {
+        gifR[i] = (i * 5 + 127) / 255 * 42;
+        gifG[i] = (i * 6 + 127) / 255 * 6;
+        gifB[i] = (i * 5 + 127) / 255;
+    }
+}
+
+// LZW codes packed LSB first into sub-blocks of up to 255 bytes
+typedef struct GifStream {
+    unsigned char *out;
+    size_t size;
+    size_t block;               // Where the current sub-block's length byte is
+    unsigned int bits;
+    int bitCount;
+} GifStream;
+
+void gifPut(GifStream *stream, int code, int codeSize) {
+    stream->bits |= (unsigned int) code << stream->bitCount;
+    stream->bitCount += codeSize;
+    while (stream->bitCount >= 8) {
+        if (stream->out[stream->block] == 255) {
+            stream->block = stream->size++;
+            stream->out[stream->block] = 0;
+        }
+        stream->out[stream->size++] = stream->bits & 0xff;
+        ++stream->out[stream->block];
+        stream->bits >>= 8;
+        stream->bitCount -= 8;
+    }
+}
+
+// Same code size rules as giflib: grow after writing a code once the next one would not fit
+size_t gifEncode(const unsigned char *indices, int count, unsigned char *out) {
+    const int clear = 256;
+    const int end = 257;
+    int keys[CAPTURE_LZW_HASH];
+    short codes[CAPTURE_LZW_HASH];
+
+    GifStream stream = { .out = out, .size = 1, .block = 0 };
+    out[0] = 0;
+    int codeSize = 9;
+    int next = end + 1;
+    memset(keys, -1, sizeof(keys));
+
+    gifPut(&stream, clear, codeSize);
+    int prefix = indices[0];
+    for (int i = 1; i < count; ++i) {
+        int key = (prefix << 8) | indices[i];
+        unsigned int h = ((unsigned int) key * 2654435761u) >> 19 & (CAPTURE_LZW_HASH - 1);
+        while (keys[h] != -1 && keys[h] != key) h = (h + 1) & (CAPTURE_LZW_HASH - 1);
+        if (keys[h] == key) {
+            prefix = codes[h];
+            continue;
+        }
+
+        gifPut(&stream, prefix, codeSize);
+        if (next >= (1 << codeSize) && codeSize < 12) ++codeSize;
+        if (next >= 4095) {
+            // Table full, start over
+            gifPut(&stream, clear, codeSize);
+            codeSize = 9;
+            next = end + 1;
+            memset(keys, -1, sizeof(keys));
+        } else {
+            keys[h] = key;
+            codes[h] = next++;
+        }
+        prefix = indices[i];
+    }
+    gifPut(&stream, prefix, codeSize);
+    if (next >= (1 << codeSize) && codeSize < 12) ++codeSize;
+    gifPut(&stream, end, codeSize);
+    if (stream.bitCount > 0) gifPut(&stream, 0, 8 - stream.bitCount);
+
+    if (out[stream.block] > 0) out[stream.size++] = 0;
+    else out[stream.block] = 0;     // Empty last sub-block doubles as the terminator
+    return stream.size;
+}
+
+void captureGif(CaptureSlot *slot) {
+    int w = capture.width;
+    int h = capture.height;
+    for (int y = 0; y < h; ++y) {
+        const unsigned char *row = slot->pixels + (size_t) (h - 1 - y) * w * 4;
+        unsigned char *indices = slot->indices + (size_t) y * w;
+        for (int x = 0; x < w; ++x) {
+            indices[x] = gifR[row[x * 4]] + gifG[row[x * 4 + 1]] + gifB[row[x * 4 + 2]];
+        }
+    }
+
+    unsigned char *out = slot->encoded;
+    // Graphic control extension, delay
+    out[0] = 0x21; out[1] = 0xf9; out[2] = 4; out[3] = 0;
+    captureWrite16(out + 4, CAPTURE_GIF_DELAY);
+    out[6] = 0; out[7] = 0;
+    // Image descriptor, whole frame, global palette
+    out[8] = 0x2c;
+    captureWrite16(out + 9, 0);
+    captureWrite16(out + 11, 0);
+    captureWrite16(out + 13, w);
+    captureWrite16(out + 15, h);
+    out[17] = 0;
+    out[18] = 8;                // LZW minimum code size
+    slot->size = 19 + gifEncode(slot->indices, w * h, out + 19);
+}
+
+// Full range BT.601, chroma averaged over 2x2
+void captureY4m(CaptureSlot *slot) {
+    int w = capture.width;
+    int h = capture.height;
+    unsigned char *out = slot->encoded;
+    memcpy(out, "FRAME\n", 6);
+    unsigned char *planeY = out + 6;
+    unsigned char *planeU = planeY + w * h;
+    unsigned char *planeV = planeU + (w / 2) * (h / 2);
+
+    for (int y = 0; y < h; ++y) {
+        const unsigned char *row = slot->pixels + (size_t) (h - 1 - y) * w * 4;
+        for (int x = 0; x < w; ++x) {
+            planeY[y * w + x] = (77 * row[x * 4] + 150 * row[x * 4 + 1] + 29 * row[x * 4 + 2] + 128) >> 8;
+        }
+    }
+    for (int y = 0; y < h / 2; ++y) {
+        const unsigned char *top = slot->pixels + (size_t) (h - 1 - y * 2) * w * 4;
+        const unsigned char *bottom = top - w * 4;
+        for (int x = 0; x < w / 2; ++x) {
+            const unsigned char *a = top + x * 8;
+            const unsigned char *b = bottom + x * 8;
+            int r = (a[0] + a[4] + b[0] + b[4] + 2) >> 2;
+            int g = (a[1] + a[5] + b[1] + b[5] + 2) >> 2;
+            int bl = (a[2] + a[6] + b[2] + b[6] + 2) >> 2;
+            // + 128.5 in 8.8, just short of a rounding carry to 256
+            planeU[y * (w / 2) + x] = (-43 * r - 85 * g + 128 * bl + 32895) >> 8;
+            planeV[y * (w / 2) + x] = (128 * r - 107 * g - 21 * bl + 32895) >> 8;
+        }
+    }
+    slot->size = 6 + w * h + (w / 2) * (h / 2) * 2;
+}
+
+void capturePng(CaptureSlot *slot) {
+    size_t stride = (size_t) capture.width * 4;
+    for (int y = 0; y < capture.height; ++y) {
+        memcpy(slot->encoded + y * stride, slot->pixels + (capture.height - 1 - y) * stride, stride);
+    }
+    // Not TextFormat, its buffers are shared between threads
+    char fileName[300];
+    snprintf(fileName, sizeof(fileName), "%s_%05d.png", capture.fileName, slot->frame);
+    Image image = { slot->encoded, capture.width, capture.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    ExportImage(image, fileName);
+}
+
+void *captureWorker(void *arg) {
+    (void) arg;
+    pthread_mutex_lock(&capture.lock);
+    while (true) {
+        CaptureSlot *slot = &capture.slots[capture.nextJob % CAPTURE_SLOTS];
+        if (!(slot->isReady && slot->frame == capture.nextJob)) {
+            if (capture.isStopping) break;
+            pthread_cond_wait(&capture.changed, &capture.lock);
+            continue;
+        }
+        slot->isReady = false;
+        ++capture.nextJob;
+        pthread_mutex_unlock(&capture.lock);
+
+        // Frames encode in parallel..
+        if (capture.format == CAPTURE_GIF) captureGif(slot);
+        else if (capture.format == CAPTURE_Y4M) captureY4m(slot);
+        else if (capture.format == CAPTURE_GOLDEN) GoldenFrame(slot->frame, slot->pixels, capture.width, capture.height, slot->encoded);
+        else capturePng(slot);
+
+        // ..and are appended in order
+        pthread_mutex_lock(&capture.lock);
+        if (capture.format == CAPTURE_GIF || capture.format == CAPTURE_Y4M) {
+            while (capture.nextWrite != slot->frame) pthread_cond_wait(&capture.changed, &capture.lock);
+            pthread_mutex_unlock(&capture.lock);
+            fwrite(slot->encoded, 1, slot->size, capture.file);
+            pthread_mutex_lock(&capture.lock);
+        }
+        ++capture.nextWrite;
+        slot->frame = -1;
+        pthread_cond_broadcast(&capture.changed);
+    }
+    pthread_mutex_unlock(&capture.lock);
+    return NULL;
+}
+
+// Maps a finished readback and hands the copy to the pool
+void captureCollect(int frame) {
+    CaptureSlot *slot = &capture.slots[frame % CAPTURE_SLOTS];
+    size_t size = (size_t) capture.width * capture.height * 4;
+
+    pthread_mutex_lock(&capture.lock);
+    if (slot->frame != -1) {
+        double t = captureNow();
+        while (slot->frame != -1) pthread_cond_wait(&capture.changed, &capture.lock);
+        capture.stall += captureNow() - t;
+    }
+    pthread_mutex_unlock(&capture.lock);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo[frame % CAPTURE_PBOS]);
+    const void *pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (pixels != NULL) {
+        memcpy(slot->pixels, pixels, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    pthread_mutex_lock(&capture.lock);
+    slot->frame = frame;
+    slot->isReady = true;
+    pthread_cond_broadcast(&capture.changed);
+    pthread_mutex_unlock(&capture.lock);
+}
+
+// Call after InitWindow, GL has to be up
+bool CaptureOpen(const char *fileName, CaptureFormat format, int width, int height, int limit) {
+    capture = (Capture) { .format = format, .width = width, .height = height, .limit = limit };
+
+    snprintf(capture.fileName, sizeof(capture.fileName), "%s", fileName);
+    if (format == CAPTURE_GOLDEN) {
+        if (!GoldenOpen(fileName)) return false;
+    } else if (format == CAPTURE_PNG) {
+        char *extension = strrchr(capture.fileName, '.');
+        if (extension != NULL && strchr(extension, '/') == NULL) *extension = '\0';
+        // ExportImage logs every file
+        SetTraceLogLevel(LOG_WARNING);
+    } else {
+        capture.file = fopen(fileName, "wb");
+        if (capture.file == NULL) return false;
+    }
+
+    if (capture.format == CAPTURE_GIF) {
+        gifHeader();
+    } else if (capture.format == CAPTURE_Y4M) {
+        // Full range, as captureY4m writes it, readers assume limited without the tag
+        fprintf(capture.file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", width, height, CAPTURE_FPS);
+    }
+
+    size_t size = (size_t) width * height * 4;
+    for (int i = 0; i < CAPTURE_SLOTS; ++i) {
+        capture.slots[i] = (CaptureSlot) {
+            .frame = -1,
+            .pixels = malloc(size),
+            .indices = capture.format == CAPTURE_GIF ? malloc((size_t) width * height) : NULL,
+            .encoded = malloc(size)     // Largest output: flipped RGBA, LZW stays under 1.6 bytes a pixel
+        };
+    }
+
+    glGenBuffers(CAPTURE_PBOS, capture.pbo);
+    for (int i = 0; i < CAPTURE_PBOS; ++i) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    pthread_mutex_init(&capture.lock, NULL);
+    pthread_cond_init(&capture.changed, NULL);
+    for (int i = 0; i < CAPTURE_WORKERS; ++i) {
+        pthread_create(&capture.workers[i], NULL, captureWorker, NULL);
+    }
+    capture.start = captureNow();
+    capture.isOpen = true;
+    return true;
+}
+
+bool CaptureFinished() {
+    return capture.isOpen && capture.limit > 0 && capture.frame >= capture.limit;
+}
+
+// Call after drawing into the target. Queues this frame's readback, collects the previous one.
+void CaptureFrame(RenderTexture2D target) {
+    if (!capture.isOpen || CaptureFinished()) return;
+
+    int frame = capture.frame++;
+    if (capture.format == CAPTURE_GIF && frame % CAPTURE_GIF_STEP != 0) return;
+
+    // The copy into the buffer runs on the GPU, nothing waits here
+    int output = capture.read++;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo[output % CAPTURE_PBOS]);
+    glReadPixels(0, 0, capture.width, capture.height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    // A whole frame later, the previous readback is done
+    if (output > 0) captureCollect(output - 1);
+}
+
+void CaptureClose() {
+    if (!capture.isOpen) return;
+
+    if (capture.read > 0) captureCollect(capture.read - 1);
+
+    pthread_mutex_lock(&capture.lock);
+    capture.isStopping = true;
+    pthread_cond_broadcast(&capture.changed);
+    pthread_mutex_unlock(&capture.lock);
+    for (int i = 0; i < CAPTURE_WORKERS; ++i) {
+        pthread_join(capture.workers[i], NULL);
+    }
+
+    if (capture.format == CAPTURE_GIF) fputc(0x3b, capture.file);
+    if (capture.file != NULL) fclose(capture.file);
+    glDeleteBuffers(CAPTURE_PBOS, capture.pbo);
+    for (int i = 0; i < CAPTURE_SLOTS; ++i) {
+        free(capture.slots[i].pixels);
+        free(capture.slots[i].indices);
+        free(capture.slots[i].encoded);
+    }
+    pthread_mutex_destroy(&capture.lock);
+    pthread_cond_destroy(&capture.changed);
+    capture.isOpen = false;
+
+    double seconds = captureNow() - capture.start;
+    printf("%-14s: %d frames -> %s\n", "capture", capture.read, capture.fileName);
+    printf("%-14s: %.1f fps, %.1fx real time\n", "capture", capture.frame / seconds, capture.frame / seconds / CAPTURE_FPS);
+    printf("%-14s: %.1f ms waiting on workers\n", "capture", capture.stall * 1000.0);
+}
+
+#endif // PLATFORM_WEB
+
+#endif // LEARN_COLORS_CAPTURE_
@@ -0,0 +1,215 @@
+#ifndef LEARN_COLORS_GOLDEN_
+#define LEARN_COLORS_GOLDEN_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// --------------------
+#define GOLDEN_TOLERANCE 2          // Per channel, software and hardware GL round blends differently
+#define GOLDEN_MAX_BAD 0.001f       // Fraction of pixels allowed over the tolerance
+#define GOLDEN_NAME "frame"         // <dir>/frame_00000.png, diffs go to <dir>/diff_00000.png
+// --------------------
+
+typedef struct GoldenDiff {
+    int bad;                    // Pixels with any of r, g, b over the tolerance
+    int peak;                   // Largest channel difference
+} GoldenDiff;
+
+// Counters are bumped by the capture workers
+typedef struct Golden {
+    bool isOpen;
+    bool isOpenFailed;          // A check that compared nothing fails too
+    const char *dir;
+    int tolerance;
+    float maxBad;
+    int compared;
+    int failed;
+    int missing;
+} Golden;
+
+Golden golden = { 0 };
+
+// 4 pixels at a time with GCC/Clang vector extensions, the same way as the CIEDE2000 batch
+#if defined(__GNUC__)
+    #define GOLDEN_SIMD 1
+
+typedef unsigned char v16u __attribute__((vector_size(16)));
+typedef unsigned int v4u __attribute__((vector_size(16)));
+#endif
+
+static inline int goldenDelta(const unsigned char *a, const unsigned char *b) {
+    int peak = 0;
+    for (int c = 0; c < 3; ++c) {
+        int d = abs(a[c] - b[c]);
+        if (d > peak) peak = d;
+    }
+    return peak;
+}
+
+GoldenDiff goldenDiffRow(const unsigned char *a, const unsigned char *b, int pixels, int tolerance) {
+    GoldenDiff diff = { 0 };
+    int i = 0;
+#if defined(GOLDEN_SIMD)
+    const v16u rgb = (v16u) (v4u) { 0x00ffffff, 0x00ffffff, 0x00ffffff, 0x00ffffff };
+    v16u limit = (v16u) { 0 } + (unsigned char) tolerance;
+    v16u peak = { 0 };
+    v4u bad = { 0 };
+    for (; i + 4 <= pixels; i += 4) {
+        v16u x;
+        v16u y;
+        memcpy(&x, a + i * 4, sizeof(x));
+        memcpy(&y, b + i * 4, sizeof(y));
+
+        // |x - y| without widening, alpha masked off
+        v16u greater = (v16u) (x > y);
+        v16u d = (((x - y) & greater) | ((y - x) & ~greater)) & rgb;
+        v16u higher = (v16u) (d > peak);
+        peak = (d & higher) | (peak & ~higher);
+
+        // A pixel is bad when any of its channels is over, lanes are -1 or 0
+        v4u over = (v4u) (d > limit);
+        bad -= (v4u) (over != 0);
+    }
+    diff.bad = bad[0] + bad[1] + bad[2] + bad[3];
+    for (int j = 0; j < 16; ++j) {
+        if (peak[j] > diff.peak) diff.peak = peak[j];
+    }
+#endif
+    for (; i < pixels; ++i) {
+        int d = goldenDelta(a + i * 4, b + i * 4);
+        if (d > diff.peak) diff.peak = d;
+        diff.bad += d > tolerance;
+    }
+    return diff;
+}
+
+// pixels are bottom row first as GL reads them, expected is a PNG, top row first
+GoldenDiff GoldenDiffImage(const unsigned char *pixels, const unsigned char *expected, int width, int height, int tolerance) {
+    GoldenDiff diff = { 0 };
+    size_t stride = (size_t) width * 4;
+    for (int y = 0; y < height; ++y) {
+        GoldenDiff row = goldenDiffRow(pixels + (height - 1 - y) * stride, expected + y * stride, width, tolerance);
+        diff.bad += row.bad;
+        if (row.peak > diff.peak) diff.peak = row.peak;
+    }
+    return diff;
+}
+
+// Faded golden frame underneath, bad pixels from red (just over) to yellow (255 off)
+void goldenHeatmap(const unsigned char *pixels, const unsigned char *expected, int width, int height, int tolerance, unsigned char *out) {
+    size_t stride = (size_t) width * 4;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char *a = pixels + (height - 1 - y) * stride;
+        const unsigned char *b = expected + y * stride;
+        unsigned char *o = out + y * stride;
+        for (int x = 0; x < width; ++x) {
+            int d = goldenDelta(a + x * 4, b + x * 4);
+            if (d > tolerance) {
+                o[x * 4] = 255;
+                o[x * 4 + 1] = d;
+                o[x * 4 + 2] = 0;
+            } else {
+                int l = (b[x * 4] * 77 + b[x * 4 + 1] * 150 + b[x * 4 + 2] * 29) >> 10;
+                o[x * 4] = o[x * 4 + 1] = o[x * 4 + 2] = l;
+            }
+            o[x * 4 + 3] = 255;
+        }
+    }
+}
+
+bool GoldenOpen(const char *dir) {
+    if (!DirectoryExists(dir)) {
+        golden = (Golden) { .isOpenFailed = true, .dir = dir };
+        return false;
+    }
+    golden = (Golden) { .isOpen = true, .dir = dir, .tolerance = GOLDEN_TOLERANCE, .maxBad = GOLDEN_MAX_BAD };
+    // LoadImage logs every file
+    SetTraceLogLevel(LOG_WARNING);
+    return true;
+}
+
+// Worker side. scratch is width * height * 4, used for the heatmap.
+void GoldenFrame(int frame, const unsigned char *pixels, int width, int height, unsigned char *scratch) {
+    char fileName[512];
+    snprintf(fileName, sizeof(fileName), "%s/%s_%05d.png", golden.dir, GOLDEN_NAME, frame);
+    if (!FileExists(fileName)) {
+        __atomic_fetch_add(&golden.missing, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    Image expected = LoadImage(fileName);
+    if (expected.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) ImageFormat(&expected, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    __atomic_fetch_add(&golden.compared, 1, __ATOMIC_RELAXED);
+
+    if (expected.width != width || expected.height != height) {
+        printf("%-14s: frame %d is %d x %d, golden %d x %d\n", "golden", frame, width, height, expected.width, expected.height);
+        __atomic_fetch_add(&golden.failed, 1, __ATOMIC_RELAXED);
+        UnloadImage(expected);
+        return;
+    }
+
+    GoldenDiff diff = GoldenDiffImage(pixels, expected.data, width, height, golden.tolerance);
+    if (diff.bad > golden.maxBad * width * height) {
+        __atomic_fetch_add(&golden.failed, 1, __ATOMIC_RELAXED);
+
+        goldenHeatmap(pixels, expected.data, width, height, golden.tolerance, scratch);
+        snprintf(fileName, sizeof(fileName), "%s/diff_%05d.png", golden.dir, frame);
+        ExportImage((Image) { scratch, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 }, fileName);
+        printf("%-14s: frame %d, %d pixels (%.2f%%) off by up to %d -> %s\n",
+                "golden", frame, diff.bad, 100.0f * diff.bad / (width * height), diff.peak, fileName);
+    }
+    UnloadImage(expected);
+}
+
+// True when every frame matched and none were missing, or no check was asked for
+bool GoldenClose() {
+    if (golden.isOpenFailed) {
+        printf("%-14s: %s could not be opened\n", "golden", golden.dir);
+        return false;
+    }
+    if (!golden.isOpen) return true;
+    golden.isOpen = false;
+    printf("%-14s: %d compared, %d failed, %d missing (tolerance %d, %.2f%% of pixels)\n",
+            "golden", golden.compared, golden.failed, golden.missing, golden.tolerance, golden.maxBad * 100.0f);
+    return golden.failed == 0 && golden.missing == 0;
+}
+
+// --bench golden, diff throughput on a game sized frame
+void GoldenBench(int width, int height, int frames) {
+    size_t size = (size_t) width * height * 4;
+    unsigned char *a = malloc(size);
+    unsigned char *b = malloc(size);
+    // b is a in PNG row order, mostly within the tolerance
+    size_t stride = (size_t) width * 4;
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = rand();
+    }
+    for (int y = 0; y < height; ++y) {
+        for (size_t x = 0; x < stride; ++x) {
+            b[y * stride + x] = a[(height - 1 - y) * stride + x] + (rand() % 5 - 2);
+        }
+    }
+
+    struct timespec start;
+    struct timespec end;
+    int bad = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < frames; ++i) {
+        bad += GoldenDiffImage(a, b, width, height, GOLDEN_TOLERANCE).bad;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    printf("%-14s: %d frames of %d x %d\n", "bench", frames, width, height);
+    printf("%-14s: %.3f ms/frame, %.0f frames/s\n", "diff", seconds / frames * 1000.0, frames / seconds);
+    printf("%-14s: %d\n", "bad", bad / frames);
+    free(a);
+    free(b);
+}
+
+#endif // LEARN_COLORS_GOLDEN_
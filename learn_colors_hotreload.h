@@ -0,0 +1,211 @@
+#ifndef LEARN_COLORS_HOTRELOAD_
+#define LEARN_COLORS_HOTRELOAD_
+
+#include "raylib.h"
+#include "learn_colors_assets.h"
+#include "learn_colors_tuning.h"
+#include "learn_colors_profiler.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+// --------------------
+#define MAX_WATCHES 16
+#define MAX_RELOADS (MAX_ASSETS + 1)    // Every tracked asset and the tuning file, so a bulk change drops nothing
+// --------------------
+
+// What HotReloadPoll changed, the game refreshes whatever copied it
+typedef enum {
+    RELOAD_TUNING = 1,
+    RELOAD_TEXTURE = 2,
+    RELOAD_SOUND = 4,
+} ReloadChange;
+
+#if defined(PLATFORM_WEB)
+
+typedef struct HotReload {
+    bool isWatching;
+} HotReload;
+
+HotReload hotReload = { 0 };
+
+bool HotReloadOpen(const char *dir, const char *tuningFile) { (void) dir; (void) tuningFile; return false; }
+int HotReloadPoll() { return 0; }
+void HotReloadClose() {}
+
+#else
+
+#include "rlgl.h"
+#include <GL/gl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+typedef struct HotReload {
+    bool isWatching;
+    int fd;
+    int watches[MAX_WATCHES];
+    char dirs[MAX_WATCHES][MAX_ASSET_PATH];
+    int noOfWatches;
+    const char *tuningFile;
+    int reloads;
+} HotReload;
+
+HotReload hotReload = { 0 };
+
+void hotReloadWatch(const char *dir) {
+    for (int i = 0; i < hotReload.noOfWatches; ++i) {
+        if (strcmp(hotReload.dirs[i], dir) == 0) return;
+    }
+    if (hotReload.noOfWatches == MAX_WATCHES) return;
+
+    // Editors often save by writing a new file and renaming it over the old one, hence MOVED_TO
+    int wd = inotify_add_watch(hotReload.fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) return;
+    hotReload.watches[hotReload.noOfWatches] = wd;
+    strncpy(hotReload.dirs[hotReload.noOfWatches], dir, MAX_ASSET_PATH - 1);
+    ++hotReload.noOfWatches;
+}
+
+// dir and its subdirectories, which is all resources/ has
+bool HotReloadOpen(const char *dir, const char *tuningFile) {
+    hotReload.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (hotReload.fd < 0) return false;
+    hotReload.tuningFile = tuningFile;
+
+    hotReloadWatch(dir);
+    DIR *entries = opendir(dir);
+    if (entries != NULL) {
+        struct dirent *entry;
+        while ((entry = readdir(entries)) != NULL) {
+            if (entry->d_name[0] == '.') continue;
+            char path[512];
+            if (snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name) >= MAX_ASSET_PATH) continue;
+            if (DirectoryExists(path)) hotReloadWatch(path);
+        }
+        closedir(entries);
+    }
+
+    // The tuning file may live somewhere else
+    char tuningDir[MAX_ASSET_PATH];
+    strncpy(tuningDir, tuningFile, MAX_ASSET_PATH - 1);
+    tuningDir[MAX_ASSET_PATH - 1] = '\0';
+    char *slash = strrchr(tuningDir, '/');
+    if (slash != NULL) *slash = '\0';
+    hotReloadWatch(slash != NULL ? tuningDir : ".");
+
+    hotReload.isWatching = hotReload.noOfWatches > 0;
+    // HotReloadClose only closes what is being watched
+    if (!hotReload.isWatching) close(hotReload.fd);
+    return hotReload.isWatching;
+}
+
+// Same GL texture id, so every copy of the Texture2D keeps drawing it.
+// A size change re-specifies the storage, copies then hold the old width and height until refreshed.
+bool reloadTexture(Texture2D *texture, const char *path) {
+    Image image = LoadImage(path);
+    if (image.data == NULL) return false;
+    if (texture->id == 0) {
+        *texture = LoadTextureFromImage(image);
+        UnloadImage(image);
+        return true;
+    }
+
+    // The old format keeps raylib's swizzle for grayscale textures right
+    if (image.format != texture->format) ImageFormat(&image, texture->format);
+    if (image.width == texture->width && image.height == texture->height) {
+        UpdateTexture(*texture, image.data);
+    } else {
+        unsigned int glInternalFormat;
+        unsigned int glFormat;
+        unsigned int glType;
+        rlGetGlTextureFormats(texture->format, &glInternalFormat, &glFormat, &glType);
+        glBindTexture(GL_TEXTURE_2D, texture->id);
+        glTexImage2D(GL_TEXTURE_2D, 0, glInternalFormat, image.width, image.height, 0, glFormat, glType, image.data);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        texture->width = image.width;
+        texture->height = image.height;
+        texture->mipmaps = 1;
+    }
+    UnloadImage(image);
+    return true;
+}
+
+// Swapped into the same Sound, sfx.* is read when a sound is played
+bool reloadSound(Sound *sound, const char *path) {
+    if (!IsAudioDeviceReady()) return false;
+    Sound fresh = LoadSound(path);
+    if (fresh.stream.buffer == NULL) return false;
+    UnloadSound(*sound);
+    *sound = fresh;
+    return true;
+}
+
+int hotReloadFile(const char *path) {
+    if (strcmp(path, hotReload.tuningFile) == 0) {
+        return LoadTuning(path) ? RELOAD_TUNING : 0;
+    }
+
+    Asset *asset = findAsset(path);
+    if (asset == NULL) return 0;
+    if (asset->type == ASSET_TEXTURE) return reloadTexture(asset->handle, path) ? RELOAD_TEXTURE : 0;
+    return reloadSound(asset->handle, path) ? RELOAD_SOUND : 0;
+}
+
+// Once a frame. Returns the ReloadChange bits, reloading frames show up as the profile's reload row.
+int HotReloadPoll() {
+    if (!hotReload.isWatching) return 0;
+
+    // A save is often several events for the same file, each file is reloaded once.
+    // Only files that can reload are kept, so paths never fills up and the queue is read to the end.
+    char paths[MAX_RELOADS][MAX_ASSET_PATH];
+    int noOfPaths = 0;
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = read(hotReload.fd, buffer, sizeof(buffer))) > 0) {
+        const struct inotify_event *event;
+        for (char *p = buffer; p < buffer + length; p += sizeof(struct inotify_event) + event->len) {
+            event = (const struct inotify_event *) p;
+            if (event->len == 0 || (event->mask & IN_ISDIR)) continue;
+
+            int index = 0;
+            while (index < hotReload.noOfWatches && hotReload.watches[index] != event->wd) ++index;
+            if (index == hotReload.noOfWatches) continue;
+
+            // Longer than any asset path, nothing to reload
+            char path[512];
+            if (snprintf(path, sizeof(path), "%s/%s", hotReload.dirs[index], event->name) >= MAX_ASSET_PATH) continue;
+            // Files nobody loaded (levels.json, editor swap files) are left alone
+            if (strcmp(path, hotReload.tuningFile) != 0 && findAsset(path) == NULL) continue;
+            bool isSeen = false;
+            for (int i = 0; i < noOfPaths && !isSeen; ++i) isSeen = strcmp(paths[i], path) == 0;
+            if (!isSeen && noOfPaths < MAX_RELOADS) strcpy(paths[noOfPaths++], path);
+        }
+    }
+    if (noOfPaths == 0) return 0;
+
+    ProfileBegin(PROFILE_RELOAD);
+    int changes = 0;
+    for (int i = 0; i < noOfPaths; ++i) {
+        double start = GetTime();
+        int change = hotReloadFile(paths[i]);
+        if (change == 0) continue;
+        changes |= change;
+        ++hotReload.reloads;
+        printf("%-14s: %s (%.2f ms)\n", "reloaded", paths[i], (GetTime() - start) * 1000.0);
+    }
+    ProfileEnd(PROFILE_RELOAD);
+    return changes;
+}
+
+void HotReloadClose() {
+    if (!hotReload.isWatching) return;
+    hotReload.isWatching = false;
+    close(hotReload.fd);
+    printf("%-14s: %d files\n", "reloaded", hotReload.reloads);
+}
+
+#endif // PLATFORM_WEB
+
+#endif // LEARN_COLORS_HOTRELOAD_
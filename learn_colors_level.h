@@ -0,0 +1,360 @@
+#ifndef LEARN_COLORS_LEVEL_
+#define LEARN_COLORS_LEVEL_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <cjson/cJSON.h>
+#endif
+
+// --------------------
+#define LEVEL_FILE "resources/levels.json"
+#define LEVEL_CACHE_FILE "resources/levels.bin"
+#define LEVEL_MAGIC 0x4c564c4c      // "LLVL"
+#define LEVEL_VERSION 2
+
+#define MAX_LEVELS 16
+#define MAX_TRAYS 6
+#define MAX_CARDS 8
+#define MAX_PALETTE 256
+#define MAX_SPRITES 16
+#define MAX_NAME 32
+// --------------------
+
+#include "learn_colors_match.h"
+
+// Everything a board needs, flat so the cache is a single read
+typedef struct Level {
+    char name[MAX_NAME];
+    int noOfTrays;
+    int noOfCards;
+    int noOfColors;
+    Color palette[MAX_PALETTE];
+    int sprites[MAX_PALETTE];           // Index into LevelCache.spriteNames, -1 = flat card
+    int trayColors[MAX_TRAYS];          // Palette index of each tray
+    int noOfCardColors;
+    int cardColors[MAX_PALETTE];        // Palette indices cards are dealt from
+    float tolerance;                    // CIEDE2000 distance a card may be from its tray
+    float tweenDuration;                // Frames, 30 frames = 500ms
+
+    // Layout, precomputed when the cache is compiled
+    Rectangle trayRects[MAX_TRAYS];
+    Rectangle cardRects[MAX_CARDS];
+} Level;
+
+typedef struct LevelCache {
+    unsigned int magic;
+    unsigned int version;
+    int screenWidth;                    // Layout was computed for this game screen
+    int screenHeight;
+    long long sourceModTime;            // GetFileModTime of LEVEL_FILE, fixed width so desktop and wasm share the cache
+    int noOfLevels;
+    int noOfSprites;
+    char spriteNames[MAX_SPRITES][MAX_NAME];    // resources/sprites/<name>.png
+    Level levels[MAX_LEVELS];
+} LevelCache;
+
+LevelCache levelCache = { 0 };
+
+// Same formula initTrays/initCards used, shrunk when the row does not fit the screen
+void layoutRow(Rectangle rects[], int count, int width, int height, int gap, int y, int screenWidth) {
+    int rowWidth = width * count + gap * (count - 1);
+    if (rowWidth > screenWidth) {
+        float scale = (float) screenWidth / rowWidth;
+        width *= scale;
+        height *= scale;
+        gap *= scale;
+    }
+
+    int startX = -(width * count) / 2;
+    for (int i = 0; i < count; ++i) {
+        rects[i] = (Rectangle) {
+            startX + screenWidth / 2 + (width * i) + (i * gap) - (gap * (count - 1)) / 2,
+            y,
+            width,
+            height
+        };
+    }
+}
+
+void layoutLevel(Level *level, int gap, int padding, int screenWidth, int screenHeight) {
+    layoutRow(level->trayRects, level->noOfTrays, TRAY_WIDTH, TRAY_HEIGHT, gap, 0, screenWidth);
+    for (int i = 0; i < level->noOfTrays; ++i) {
+        level->trayRects[i].y = screenHeight - level->trayRects[i].height - padding;
+    }
+    layoutRow(level->cardRects, level->noOfCards, CARD_WIDTH, CARD_HEIGHT, gap, padding, screenWidth);
+}
+
+int addSprite(LevelCache *cache, const char *name) {
+    for (int i = 0; i < cache->noOfSprites; ++i) {
+        if (strcmp(cache->spriteNames[i], name) == 0) return i;
+    }
+    if (cache->noOfSprites >= MAX_SPRITES) {
+        printf("%s: more than %d sprites, %s ignored\n", LEVEL_FILE, MAX_SPRITES, name);
+        return -1;
+    }
+    strncpy(cache->spriteNames[cache->noOfSprites], name, MAX_NAME - 1);
+    return cache->noOfSprites++;
+}
+
+// The board the game always had, used when there is no cache or JSON to read
+void DefaultLevels(LevelCache *cache, int screenWidth, int screenHeight) {
+    *cache = (LevelCache) {
+        .magic = LEVEL_MAGIC,
+        .version = LEVEL_VERSION,
+        .screenWidth = screenWidth,
+        .screenHeight = screenHeight,
+        .noOfLevels = 1
+    };
+
+    Level *level = &cache->levels[0];
+    Color colors[] = { RED, GREEN, BLUE, ORANGE, PINK, PURPLE, SKYBLUE, GRAY };
+    const char *sprites[] = { "red", "green", "blue" };
+
+    strcpy(level->name, "primary");
+    level->noOfTrays = 3;
+    level->noOfCards = 4;
+    level->noOfColors = 8;
+    level->tweenDuration = 30.0f;
+    level->tolerance = DEFAULT_TOLERANCE;
+    for (int i = 0; i < level->noOfColors; ++i) {
+        level->palette[i] = colors[i];
+        level->sprites[i] = i < 3 ? addSprite(cache, sprites[i]) : -1;
+    }
+    for (int i = 0; i < level->noOfTrays; ++i) {
+        level->trayColors[i] = i;
+        level->cardColors[i] = i;
+    }
+    level->noOfCardColors = level->noOfTrays;
+    layoutLevel(level, GAP, PADDING, screenWidth, screenHeight);
+}
+
+#if !defined(PLATFORM_WEB)
+// "#rrggbb" or [r, g, b]
+bool parseColor(const cJSON *item, Color *color) {
+    if (cJSON_IsString(item)) {
+        unsigned int r, g, b;
+        if (sscanf(item->valuestring, "#%02x%02x%02x", &r, &g, &b) != 3) return false;
+        *color = (Color) { r, g, b, 255 };
+        return true;
+    }
+    if (cJSON_IsArray(item) && cJSON_GetArraySize(item) == 3) {
+        *color = (Color) {
+            cJSON_GetArrayItem(item, 0)->valueint,
+            cJSON_GetArrayItem(item, 1)->valueint,
+            cJSON_GetArrayItem(item, 2)->valueint,
+            255
+        };
+        return true;
+    }
+    return false;
+}
+
+int getInt(const cJSON *object, const char *name, int fallback) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+    return cJSON_IsNumber(item) ? item->valueint : fallback;
+}
+float getFloat(const cJSON *object, const char *name, float fallback) {
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+    return cJSON_IsNumber(item) ? (float) item->valuedouble : fallback;
+}
+
+// Every card color has to land in at least one tray, or the round can never finish
+bool checkCardColors(const Level *level) {
+    // Static, the distance table is too big for the stack, and the live colorMatch is left alone
+    static ColorMatch scratch;
+    BuildColorMatch(&scratch, level->palette, level->noOfColors, level->tolerance);
+
+    bool isValid = true;
+    for (int i = 0; i < level->noOfCardColors; ++i) {
+        int matches = 0;
+        for (int j = 0; j < level->noOfTrays; ++j) {
+            matches += ColorsMatch(&scratch, level->cardColors[i], level->trayColors[j]);
+        }
+        if (matches == 0) {
+            printf("%s: level %s, card color %d matches no tray\n", LEVEL_FILE, level->name, level->cardColors[i]);
+            isValid = false;
+        } else if (matches > 1) {
+            printf("%s: level %s, card color %d matches %d trays\n", LEVEL_FILE, level->name, level->cardColors[i], matches);
+        }
+    }
+    return isValid;
+}
+
+bool parseLevel(LevelCache *cache, Level *level, const cJSON *json, int screenWidth, int screenHeight) {
+    const cJSON *name = cJSON_GetObjectItemCaseSensitive(json, "name");
+    const cJSON *palette = cJSON_GetObjectItemCaseSensitive(json, "palette");
+    const cJSON *trayColors = cJSON_GetObjectItemCaseSensitive(json, "trayColors");
+    const cJSON *cardColors = cJSON_GetObjectItemCaseSensitive(json, "cardColors");
+
+    *level = (Level) { 0 };
+    if (cJSON_IsString(name)) strncpy(level->name, name->valuestring, MAX_NAME - 1);
+    level->noOfTrays = MAX(1, MIN(getInt(json, "trays", 3), MAX_TRAYS));
+    level->noOfCards = MAX(1, MIN(getInt(json, "cards", 4), MAX_CARDS));
+    level->tweenDuration = getInt(json, "tweenDuration", 30);
+    if (level->tweenDuration <= 0) {
+        printf("%s: level %s, tweenDuration must be above 0\n", LEVEL_FILE, level->name);
+        return false;
+    }
+    level->tolerance = getFloat(json, "tolerance", DEFAULT_TOLERANCE);
+
+    if (!cJSON_IsArray(palette)) {
+        printf("%s: level %s has no palette\n", LEVEL_FILE, level->name);
+        return false;
+    }
+    const cJSON *entry;
+    cJSON_ArrayForEach(entry, palette) {
+        if (level->noOfColors >= MAX_PALETTE) break;
+
+        // Either a bare color or { "color": ..., "sprite": "red" }
+        const cJSON *color = cJSON_IsObject(entry) ? cJSON_GetObjectItemCaseSensitive(entry, "color") : entry;
+        const cJSON *sprite = cJSON_GetObjectItemCaseSensitive(entry, "sprite");
+        int index = level->noOfColors++;
+        if (!parseColor(color, &level->palette[index])) {
+            printf("%s: level %s, bad color at %d\n", LEVEL_FILE, level->name, index);
+            return false;
+        }
+        level->sprites[index] = cJSON_IsString(sprite) ? addSprite(cache, sprite->valuestring) : -1;
+    }
+
+    // Trays default to the first colors of the palette
+    for (int i = 0; i < level->noOfTrays; ++i) {
+        const cJSON *item = cJSON_IsArray(trayColors) ? cJSON_GetArrayItem(trayColors, i) : NULL;
+        level->trayColors[i] = cJSON_IsNumber(item) ? item->valueint : i;
+        if (level->trayColors[i] < 0 || level->trayColors[i] >= level->noOfColors) {
+            printf("%s: level %s, tray %d has no color\n", LEVEL_FILE, level->name, i);
+            return false;
+        }
+    }
+
+    // Cards default to the tray colors
+    const cJSON *item;
+    cJSON_ArrayForEach(item, cardColors) {
+        if (!cJSON_IsNumber(item) || item->valueint < 0 || item->valueint >= level->noOfColors) {
+            printf("%s: level %s, card color %d is not in the palette\n", LEVEL_FILE, level->name, level->noOfCardColors);
+            return false;
+        }
+        level->cardColors[level->noOfCardColors++] = item->valueint;
+    }
+    if (level->noOfCardColors == 0) {
+        memcpy(level->cardColors, level->trayColors, sizeof(int) * level->noOfTrays);
+        level->noOfCardColors = level->noOfTrays;
+    }
+    if (!checkCardColors(level)) return false;
+
+    layoutLevel(level, getInt(json, "gap", GAP), getInt(json, "padding", PADDING), screenWidth, screenHeight);
+    return true;
+}
+
+bool CompileLevels(const char *fileName, LevelCache *cache, int screenWidth, int screenHeight) {
+    char *text = LoadFileText(fileName);
+    if (text == NULL) return false;
+
+    cJSON *json = cJSON_Parse(text);
+    UnloadFileText(text);
+    if (json == NULL) {
+        printf("%s: parse error near %.20s\n", fileName, cJSON_GetErrorPtr());
+        return false;
+    }
+
+    *cache = (LevelCache) {
+        .magic = LEVEL_MAGIC,
+        .version = LEVEL_VERSION,
+        .screenWidth = screenWidth,
+        .screenHeight = screenHeight,
+        .sourceModTime = GetFileModTime(fileName)
+    };
+
+    bool isValid = true;
+    const cJSON *level;
+    cJSON_ArrayForEach(level, cJSON_GetObjectItemCaseSensitive(json, "levels")) {
+        if (cache->noOfLevels >= MAX_LEVELS) break;
+        isValid = parseLevel(cache, &cache->levels[cache->noOfLevels++], level, screenWidth, screenHeight) && isValid;
+    }
+    cJSON_Delete(json);
+
+    return isValid && cache->noOfLevels > 0;
+}
+#endif
+
+// The cache is used as read, counts size fixed arrays and color and sprite values index them.
+// A corrupt or old cache must not get past here.
+bool isLevelCacheSane(const LevelCache *cache) {
+    if (cache->noOfLevels < 1 || cache->noOfLevels > MAX_LEVELS) return false;
+    if (cache->noOfSprites < 0 || cache->noOfSprites > MAX_SPRITES) return false;
+    for (int i = 0; i < cache->noOfLevels; ++i) {
+        const Level *level = &cache->levels[i];
+        if (level->noOfTrays < 1 || level->noOfTrays > MAX_TRAYS) return false;
+        if (level->noOfCards < 1 || level->noOfCards > MAX_CARDS) return false;
+        if (level->noOfColors < 1 || level->noOfColors > MAX_PALETTE) return false;
+        if (level->noOfCardColors < 1 || level->noOfCardColors > MAX_PALETTE) return false;
+        // Divides in EaseBackOut, and catches NaN
+        if (!(level->tweenDuration > 0.0f)) return false;
+
+        for (int j = 0; j < level->noOfColors; ++j) {
+            if (level->sprites[j] < -1 || level->sprites[j] >= cache->noOfSprites) return false;
+        }
+        for (int j = 0; j < level->noOfTrays; ++j) {
+            if (level->trayColors[j] < 0 || level->trayColors[j] >= level->noOfColors) return false;
+        }
+        for (int j = 0; j < level->noOfCardColors; ++j) {
+            if (level->cardColors[j] < 0 || level->cardColors[j] >= level->noOfColors) return false;
+        }
+    }
+    return true;
+}
+
+bool LoadLevelCache(const char *fileName, LevelCache *cache) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    bool isLoaded = fread(cache, sizeof(LevelCache), 1, file) == 1
+        && cache->magic == LEVEL_MAGIC
+        && cache->version == LEVEL_VERSION;
+    fclose(file);
+    if (isLoaded && !isLevelCacheSane(cache)) {
+        printf("%s: corrupt, ignored\n", fileName);
+        isLoaded = false;
+    }
+    return isLoaded;
+}
+
+bool SaveLevelCache(const char *fileName, const LevelCache *cache) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    bool isSaved = fwrite(cache, sizeof(LevelCache), 1, file) == 1;
+    fclose(file);
+    return isSaved;
+}
+
+// Cache when it is current, otherwise compile the JSON once and write the cache, otherwise the default board
+void LoadLevels(int screenWidth, int screenHeight) {
+    bool isCurrent = LoadLevelCache(LEVEL_CACHE_FILE, &levelCache)
+        && levelCache.screenWidth == screenWidth
+        && levelCache.screenHeight == screenHeight;
+
+#if !defined(PLATFORM_WEB)
+    if (isCurrent && FileExists(LEVEL_FILE)) {
+        isCurrent = levelCache.sourceModTime == GetFileModTime(LEVEL_FILE);
+    }
+    if (!isCurrent && CompileLevels(LEVEL_FILE, &levelCache, screenWidth, screenHeight)) {
+        isCurrent = true;
+        printf("%-14s: %s -> %s\n", "compiled", LEVEL_FILE, LEVEL_CACHE_FILE);
+        if (!SaveLevelCache(LEVEL_CACHE_FILE, &levelCache)) {
+            printf("%s: could not write cache\n", LEVEL_CACHE_FILE);
+        }
+    }
+#endif
+
+    if (!isCurrent) {
+        DefaultLevels(&levelCache, screenWidth, screenHeight);
+    }
+    printf("%-14s: %d\n", "levels", levelCache.noOfLevels);
+}
+
+#endif // LEARN_COLORS_LEVEL_
@@ -0,0 +1,351 @@
+#ifndef LEARN_COLORS_MATCH_
+#define LEARN_COLORS_MATCH_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// --------------------
+#define DEFAULT_TOLERANCE 0.0f      // CIEDE2000 units, 0 = exact colors only, ~2.3 = just noticeable
+#define POW_25_7 6103515625.0f      // 25^7
+#define DEG2RADF 0.017453292519943295f
+#define RAD2DEGF 57.29577951308232f
+// --------------------
+
+// Needs MAX_PALETTE, learn_colors_level.h includes this
+typedef struct ColorLab {
+    float l;
+    float a;
+    float b;
+} ColorLab;
+
+// Palette in CIELAB and every pair distance, rebuilt when a palette loads
+typedef struct ColorMatch {
+    const Color *palette;       // The palette the table was built from
+    int noOfColors;
+    float tolerance;
+    float l[MAX_PALETTE];       // Structure of arrays so the batch path loads 4 at a time
+    float a[MAX_PALETTE];
+    float b[MAX_PALETTE];
+    float distance[MAX_PALETTE][MAX_PALETTE];
+} ColorMatch;
+
+ColorMatch colorMatch = { 0 };
+
+float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+float labF(float t) {
+    return t > 216.0f / 24389.0f ? cbrtf(t) : (24389.0f / 27.0f * t + 16.0f) / 116.0f;
+}
+
+// sRGB, D65 white
+ColorLab ColorToLab(Color color) {
+    float r = srgbToLinear(color.r / 255.0f);
+    float g = srgbToLinear(color.g / 255.0f);
+    float b = srgbToLinear(color.b / 255.0f);
+
+    float x = labF((0.4124564f * r + 0.3575761f * g + 0.1804375f * b) / 0.95047f);
+    float y = labF((0.2126729f * r + 0.7151522f * g + 0.0721750f * b) / 1.00000f);
+    float z = labF((0.0193339f * r + 0.1191920f * g + 0.9503041f * b) / 1.08883f);
+
+    return (ColorLab) { 116.0f * y - 16.0f, 500.0f * (x - y), 200.0f * (y - z) };
+}
+
+float pow7(float x) {
+    float x2 = x * x;
+    return x2 * x2 * x2 * x;
+}
+
+// Sharma, Wu, Dalal, "The CIEDE2000 Color-Difference Formula" (2005)
+float DeltaE2000(ColorLab x, ColorLab y) {
+    float c1 = sqrtf(x.a * x.a + x.b * x.b);
+    float c2 = sqrtf(y.a * y.a + y.b * y.b);
+    float cBar7 = pow7((c1 + c2) * 0.5f);
+    float g = 0.5f * (1.0f - sqrtf(cBar7 / (cBar7 + POW_25_7)));
+
+    float a1 = x.a * (1.0f + g);
+    float a2 = y.a * (1.0f + g);
+    float c1p = sqrtf(a1 * a1 + x.b * x.b);
+    float c2p = sqrtf(a2 * a2 + y.b * y.b);
+    float h1p = atan2f(x.b, a1) * RAD2DEGF;
+    float h2p = atan2f(y.b, a2) * RAD2DEGF;
+    if (h1p < 0.0f) h1p += 360.0f;
+    if (h2p < 0.0f) h2p += 360.0f;
+
+    bool isAchromatic = c1p * c2p == 0.0f;
+    float dL = y.l - x.l;
+    float dC = c2p - c1p;
+    float dh = h2p - h1p;
+    if (dh > 180.0f) dh -= 360.0f;
+    else if (dh < -180.0f) dh += 360.0f;
+    if (isAchromatic) dh = 0.0f;
+    float dH = 2.0f * sqrtf(c1p * c2p) * sinf(dh * 0.5f * DEG2RADF);
+
+    float lBar = (x.l + y.l) * 0.5f;
+    float cBarP = (c1p + c2p) * 0.5f;
+    float hSum = h1p + h2p;
+    float hBar;
+    if (isAchromatic) hBar = hSum;
+    else if (fabsf(h1p - h2p) <= 180.0f) hBar = hSum * 0.5f;
+    else if (hSum < 360.0f) hBar = (hSum + 360.0f) * 0.5f;
+    else hBar = (hSum - 360.0f) * 0.5f;
+
+    float t = 1.0f
+        - 0.17f * cosf((hBar - 30.0f) * DEG2RADF)
+        + 0.24f * cosf((2.0f * hBar) * DEG2RADF)
+        + 0.32f * cosf((3.0f * hBar + 6.0f) * DEG2RADF)
+        - 0.20f * cosf((4.0f * hBar - 63.0f) * DEG2RADF);
+    float dTheta = 30.0f * expf(-((hBar - 275.0f) / 25.0f) * ((hBar - 275.0f) / 25.0f));
+    float cBarP7 = pow7(cBarP);
+    float rc = 2.0f * sqrtf(cBarP7 / (cBarP7 + POW_25_7));
+    float lBar50 = (lBar - 50.0f) * (lBar - 50.0f);
+    float sl = 1.0f + 0.015f * lBar50 / sqrtf(20.0f + lBar50);
+    float sc = 1.0f + 0.045f * cBarP;
+    float sh = 1.0f + 0.015f * cBarP * t;
+    float rt = -sinf(2.0f * dTheta * DEG2RADF) * rc;
+
+    float l = dL / sl;
+    float c = dC / sc;
+    float h = dH / sh;
+    return sqrtf(l * l + c * c + h * h + rt * c * h);
+}
+
+// Batch path, 4 lanes at a time with GCC/Clang vector extensions.
+// Lowers to SSE2 on x86-64, NEON on ARM and simd128 on wasm built with -msimd128.
+#if defined(__GNUC__)
+    #define MATCH_SIMD 1
+
+typedef float v4f __attribute__((vector_size(16)));
+typedef int v4i __attribute__((vector_size(16)));
+
+static inline v4f v4Set(float x) { return (v4f) { x, x, x, x }; }
+static inline v4f v4Load(const float *p) { v4f v; memcpy(&v, p, sizeof(v)); return v; }
+static inline v4f v4Select(v4i mask, v4f a, v4f b) { return (v4f) (((v4i) a & mask) | ((v4i) b & ~mask)); }
+static inline v4f v4Abs(v4f x) { return (v4f) ((v4i) x & 0x7fffffff); }
+static inline v4f v4Min(v4f a, v4f b) { return v4Select(a < b, a, b); }
+static inline v4f v4Max(v4f a, v4f b) { return v4Select(a > b, a, b); }
+static inline v4f v4Floor(v4f x) {
+    v4f t = __builtin_convertvector(__builtin_convertvector(x, v4i), v4f);
+    return t - v4Select(t > x, v4Set(1.0f), v4Set(0.0f));
+}
+static inline v4f v4Sqrt(v4f x) {
+#if defined(__SSE__)
+    return __builtin_ia32_sqrtps(x);
+#elif defined(__wasm_simd128__)
+    return __builtin_wasm_sqrt_f32x4(x);
+#else
+    return (v4f) { sqrtf(x[0]), sqrtf(x[1]), sqrtf(x[2]), sqrtf(x[3]) };
+#endif
+}
+
+// Radians, max error ~2e-6
+static inline v4f v4Atan2(v4f y, v4f x) {
+    v4f ax = v4Abs(x);
+    v4f ay = v4Abs(y);
+    v4f a = v4Min(ax, ay) / v4Max(v4Max(ax, ay), v4Set(1e-30f));
+    v4f s = a * a;
+    v4f p = v4Set(-0.01172120f);
+    p = p * s + 0.05265332f;
+    p = p * s - 0.11643287f;
+    p = p * s + 0.19354346f;
+    p = p * s - 0.33262347f;
+    p = p * s + 0.99997726f;
+    v4f r = p * a;
+    r = v4Select(ay > ax, 1.57079637f - r, r);
+    r = v4Select(x < 0.0f, 3.14159274f - r, r);
+    return v4Select(y < 0.0f, -r, r);
+}
+
+// Radians, any range, reduced to [-pi/2, pi/2] then Taylor to x^11
+static inline v4f v4Sin(v4f x) {
+    x -= v4Floor(x * 0.159154943f + 0.5f) * 6.28318548f;
+    x = v4Select(x > 1.57079637f, 3.14159274f - x, x);
+    x = v4Select(x < -1.57079637f, -3.14159274f - x, x);
+    v4f s = x * x;
+    v4f p = v4Set(-2.5052108e-8f);
+    p = p * s + 2.7557319e-6f;
+    p = p * s - 1.9841270e-4f;
+    p = p * s + 8.3333333e-3f;
+    p = p * s - 1.6666667e-1f;
+    return x + x * s * p;
+}
+static inline v4f v4Cos(v4f x) {
+    return v4Sin(x + 1.57079637f);
+}
+
+// e^x for x <= 0, 2^n * polynomial(fraction)
+static inline v4f v4Exp(v4f x) {
+    x = v4Max(x, v4Set(-87.0f));
+    v4f n = v4Floor(x * 1.44269504f + 0.5f);
+    v4f f = x - n * 0.693147181f;
+    v4f p = v4Set(1.0f / 720.0f);
+    p = p * f + 1.0f / 120.0f;
+    p = p * f + 1.0f / 24.0f;
+    p = p * f + 1.0f / 6.0f;
+    p = p * f + 0.5f;
+    p = p * f + 1.0f;
+    p = p * f + 1.0f;
+    v4i bits = (__builtin_convertvector(n, v4i) + 127) << 23;
+    return p * (v4f) bits;
+}
+
+// Same steps as DeltaE2000, branches become masks
+static inline v4f v4DeltaE2000(ColorLab x, v4f l2, v4f a2in, v4f b2) {
+    v4f l1 = v4Set(x.l);
+    v4f b1 = v4Set(x.b);
+    v4f c1 = v4Set(sqrtf(x.a * x.a + x.b * x.b));
+    v4f c2 = v4Sqrt(a2in * a2in + b2 * b2);
+    v4f cBar = (c1 + c2) * 0.5f;
+    v4f cBar2 = cBar * cBar;
+    v4f cBar7 = cBar2 * cBar2 * cBar2 * cBar;
+    v4f g = 0.5f * (1.0f - v4Sqrt(cBar7 / (cBar7 + POW_25_7)));
+
+    v4f a1 = x.a * (1.0f + g);
+    v4f a2 = a2in * (1.0f + g);
+    v4f c1p = v4Sqrt(a1 * a1 + b1 * b1);
+    v4f c2p = v4Sqrt(a2 * a2 + b2 * b2);
+    v4f h1p = v4Atan2(b1, a1) * RAD2DEGF;
+    v4f h2p = v4Atan2(b2, a2) * RAD2DEGF;
+    h1p += v4Select(h1p < 0.0f, v4Set(360.0f), v4Set(0.0f));
+    h2p += v4Select(h2p < 0.0f, v4Set(360.0f), v4Set(0.0f));
+
+    v4i isAchromatic = c1p * c2p == 0.0f;
+    v4f dL = l2 - l1;
+    v4f dC = c2p - c1p;
+    v4f dh = h2p - h1p;
+    dh -= v4Select(dh > 180.0f, v4Set(360.0f), v4Set(0.0f));
+    dh += v4Select(dh < -180.0f, v4Set(360.0f), v4Set(0.0f));
+    dh = v4Select(isAchromatic, v4Set(0.0f), dh);
+    v4f dH = 2.0f * v4Sqrt(c1p * c2p) * v4Sin(dh * (0.5f * DEG2RADF));
+
+    v4f lBar = (l1 + l2) * 0.5f;
+    v4f cBarP = (c1p + c2p) * 0.5f;
+    v4f hSum = h1p + h2p;
+    v4f hWrap = v4Select(hSum < 360.0f, hSum + 360.0f, hSum - 360.0f) * 0.5f;
+    v4f hBar = v4Select(v4Abs(h1p - h2p) <= 180.0f, hSum * 0.5f, hWrap);
+    hBar = v4Select(isAchromatic, hSum, hBar);
+
+    v4f t = 1.0f
+        - 0.17f * v4Cos((hBar - 30.0f) * DEG2RADF)
+        + 0.24f * v4Cos((2.0f * hBar) * DEG2RADF)
+        + 0.32f * v4Cos((3.0f * hBar + 6.0f) * DEG2RADF)
+        - 0.20f * v4Cos((4.0f * hBar - 63.0f) * DEG2RADF);
+    v4f hTheta = (hBar - 275.0f) / 25.0f;
+    v4f dTheta = 30.0f * v4Exp(-hTheta * hTheta);
+    v4f cBarP2 = cBarP * cBarP;
+    v4f cBarP7 = cBarP2 * cBarP2 * cBarP2 * cBarP;
+    v4f rc = 2.0f * v4Sqrt(cBarP7 / (cBarP7 + POW_25_7));
+    v4f lBar50 = (lBar - 50.0f) * (lBar - 50.0f);
+    v4f sl = 1.0f + 0.015f * lBar50 / v4Sqrt(20.0f + lBar50);
+    v4f sc = 1.0f + 0.045f * cBarP;
+    v4f sh = 1.0f + 0.015f * cBarP * t;
+    v4f rt = -v4Sin(2.0f * dTheta * DEG2RADF) * rc;
+
+    v4f l = dL / sl;
+    v4f c = dC / sc;
+    v4f h = dH / sh;
+    return v4Sqrt(v4Max(l * l + c * c + h * h + rt * c * h, v4Set(0.0f)));
+}
+#endif
+
+// Distance from one color to count entries of a structure of arrays palette
+void DeltaE2000Batch(ColorLab x, const float *l, const float *a, const float *b, int count, float *out) {
+    int i = 0;
+#if defined(MATCH_SIMD)
+    for (; i + 4 <= count; i += 4) {
+        v4f d = v4DeltaE2000(x, v4Load(l + i), v4Load(a + i), v4Load(b + i));
+        memcpy(out + i, &d, sizeof(d));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = DeltaE2000(x, (ColorLab) { l[i], a[i], b[i] });
+    }
+}
+
+void BuildColorMatch(ColorMatch *match, const Color *palette, int count, float tolerance) {
+    match->palette = palette;
+    match->noOfColors = count;
+    match->tolerance = tolerance;
+
+    for (int i = 0; i < count; ++i) {
+        ColorLab lab = ColorToLab(palette[i]);
+        match->l[i] = lab.l;
+        match->a[i] = lab.a;
+        match->b[i] = lab.b;
+    }
+    for (int i = 0; i < count; ++i) {
+        ColorLab lab = { match->l[i], match->a[i], match->b[i] };
+        DeltaE2000Batch(lab, match->l, match->a, match->b, count, match->distance[i]);
+        match->distance[i][i] = 0.0f;
+    }
+}
+
+// O(1), one table lookup per candidate tray
+float ColorDistance(const ColorMatch *match, int a, int b) {
+    return match->distance[a][b];
+}
+bool ColorsMatch(const ColorMatch *match, int a, int b) {
+    return match->distance[a][b] <= match->tolerance;
+}
+
+// --bench match, the full distance table of a random palette, one pair at a time and batched
+void MatchBench(int count, int tables) {
+    static ColorMatch match;
+    static float scalar[MAX_PALETTE][MAX_PALETTE];
+    static Color palette[MAX_PALETTE];
+    for (int i = 0; i < count; ++i) {
+        palette[i] = (Color) { rand(), rand(), rand(), 255 };
+    }
+    BuildColorMatch(&match, palette, count, DEFAULT_TOLERANCE);
+
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < tables; ++t) {
+        for (int i = 0; i < count; ++i) {
+            ColorLab x = { match.l[i], match.a[i], match.b[i] };
+            for (int j = 0; j < count; ++j) {
+                scalar[i][j] = DeltaE2000(x, (ColorLab) { match.l[j], match.a[j], match.b[j] });
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double scalarSeconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < tables; ++t) {
+        for (int i = 0; i < count; ++i) {
+            ColorLab x = { match.l[i], match.a[i], match.b[i] };
+            DeltaE2000Batch(x, match.l, match.a, match.b, count, match.distance[i]);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double batchSeconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    // Both tables are kept, so neither loop can be optimized away
+    float error = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < count; ++j) {
+            error = fmaxf(error, fabsf(scalar[i][j] - match.distance[i][j]));
+        }
+    }
+
+    double pairs = (double) count * count * tables;
+#if defined(MATCH_SIMD)
+    const char *batch = "batch x4";
+#else
+    const char *batch = "batch";
+#endif
+    printf("%-14s: %d tables of %d x %d colors\n", "bench", tables, count, count);
+    printf("%-14s: %.1f ns/pair, %.3f ms/table\n", "DeltaE2000", scalarSeconds / pairs * 1e9, scalarSeconds / tables * 1000.0);
+    printf("%-14s: %.1f ns/pair, %.3f ms/table, %.2fx\n", batch, batchSeconds / pairs * 1e9, batchSeconds / tables * 1000.0, scalarSeconds / batchSeconds);
+    printf("%-14s: %.6f\n", "max error", error);
+}
+
+#endif // LEARN_COLORS_MATCH_
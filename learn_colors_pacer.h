@@ -0,0 +1,145 @@
+#ifndef LEARN_COLORS_PACER_
+#define LEARN_COLORS_PACER_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+
+// --------------------
+#define PACER_FPS 60
+#define PACER_SPIN 0.002            // Seconds, sleep until this close to the deadline then spin
+#define PACER_SAMPLES 8192          // Power of two, intervals kept for the percentiles
+// --------------------
+
+typedef enum {
+    PACER_OFF = 0,              // Uncapped, sweep and capture
+    PACER_HYBRID,               // Sleep then spin to each deadline
+    PACER_VSYNC,                // The swap waits, the pacer only measures
+} PacerMode;
+
+typedef struct Pacer {
+    PacerMode mode;
+    int fps;
+    double period;
+    double next;                // Deadline of the frame being made
+    double last;                // When the previous frame started
+    float frameTime;            // Interval snapped to whole periods, what animation advances by
+    float intervals[PACER_SAMPLES];
+    int count;                  // Intervals seen, the ring keeps the last PACER_SAMPLES
+    int misses;                 // Frames done after their deadline
+} Pacer;
+
+Pacer pacer = { 0 };
+
+double pacerNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Call after InitWindow. fps <= 0 takes the monitor's refresh rate for vsync, PACER_FPS otherwise.
+void PacerBegin(PacerMode mode, int fps) {
+    if (fps <= 0) fps = mode == PACER_VSYNC ? GetMonitorRefreshRate(GetCurrentMonitor()) : PACER_FPS;
+    if (fps <= 0) fps = PACER_FPS;
+    pacer = (Pacer) { .mode = mode, .fps = fps, .period = 1.0 / fps, .frameTime = 1.0f / fps };
+    pacer.last = pacerNow();
+    pacer.next = pacer.last + pacer.period;
+
+    // raylib's own wait is a plain sleep, the pacer replaces it
+    SetTargetFPS(0);
+}
+
+void pacerRecord(double now) {
+    double interval = now - pacer.last;
+    pacer.last = now;
+    pacer.intervals[pacer.count++ & (PACER_SAMPLES - 1)] = interval;
+
+    // Whole periods, so a frame that jitters by 0.3ms still moves the clouds by exactly one step
+    int periods = (int) (interval / pacer.period + 0.5);
+    pacer.frameTime = (periods < 1 ? 1 : periods) * pacer.period;
+}
+
+// Call once the frame is drawn, before the swap and the input poll that comes with it
+void PacerWait() {
+    if (pacer.mode == PACER_OFF) return;
+
+    double now = pacerNow();
+    if (pacer.mode == PACER_VSYNC) {
+        if (now - pacer.last > pacer.period * 1.5) ++pacer.misses;
+        pacerRecord(now);
+        return;
+    }
+
+    if (now > pacer.next) {
+        ++pacer.misses;
+        // More than a frame behind, start again from here rather than rush to catch up
+        if (now - pacer.next > pacer.period) pacer.next = now;
+    }
+
+    // Sleep overshoots by up to a scheduler tick, the last stretch is spent spinning
+    double remaining = pacer.next - now;
+    if (remaining > PACER_SPIN) {
+        double sleep = remaining - PACER_SPIN;
+        struct timespec duration = { (time_t) sleep, (long) ((sleep - (time_t) sleep) * 1e9) };
+        nanosleep(&duration, NULL);
+    }
+    while ((now = pacerNow()) < pacer.next) {
+        // Spin
+    }
+
+    pacerRecord(now);
+    pacer.next += pacer.period;
+}
+
+// Web frames come from requestAnimationFrame, a 120Hz display skips every other one at 60
+bool PacerReady() {
+    if (pacer.mode == PACER_OFF) return true;
+
+    double now = pacerNow();
+    if (now < pacer.next - pacer.period * 0.5) return false;
+    if (now - pacer.last > pacer.period * 1.5) ++pacer.misses;
+    pacerRecord(now);
+    pacer.next += pacer.period;
+    if (pacer.next < now) pacer.next = now + pacer.period;
+    return true;
+}
+
+// What animation should advance by, GetFrameTime() when not pacing
+float PacerFrameTime() {
+    return pacer.mode == PACER_OFF ? GetFrameTime() : pacer.frameTime;
+}
+
+int comparePacerSamples(const void *a, const void *b) {
+    float x = *(const float *) a;
+    float y = *(const float *) b;
+    return (x > y) - (x < y);
+}
+
+// Jitter = |interval - period|, over the last PACER_SAMPLES frames
+void PacerPrint() {
+    if (pacer.mode == PACER_OFF || pacer.count == 0) return;
+
+    static float jitter[PACER_SAMPLES];
+    int count = pacer.count < PACER_SAMPLES ? pacer.count : PACER_SAMPLES;
+    double total = 0.0;
+    for (int i = 0; i < count; ++i) {
+        total += pacer.intervals[i];
+        jitter[i] = fabsf(pacer.intervals[i] - (float) pacer.period);
+    }
+    qsort(jitter, count, sizeof(float), comparePacerSamples);
+
+    static const char *modes[] = { "off", "hybrid", "vsync" };
+    printf("%-14s: %s %d fps, %.2f fps measured\n", "pacing", modes[pacer.mode], pacer.fps, count / total);
+    printf("%-14s: %d of %d (%.2f%%)\n", "missed", pacer.misses, pacer.count, 100.0f * pacer.misses / pacer.count);
+    printf("%-14s: p50 %.3f  p95 %.3f  p99 %.3f  max %.3f ms\n", "jitter",
+            jitter[count / 2] * 1000.0f,
+            jitter[(int) (count * 0.95f)] * 1000.0f,
+            jitter[(int) (count * 0.99f)] * 1000.0f,
+            jitter[count - 1] * 1000.0f);
+}
+
+#endif // LEARN_COLORS_PACER_
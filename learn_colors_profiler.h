@@ -0,0 +1,86 @@
+#ifndef LEARN_COLORS_PROFILER_
+#define LEARN_COLORS_PROFILER_
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <float.h>
+
+// --------------------
+typedef enum {
+    PROFILE_FRAME = 0,          // Whole GameLoop
+    PROFILE_INPUT,
+    PROFILE_UPDATE,
+    PROFILE_DRAW,               // Render texture
+    PROFILE_PRESENT,            // Scale to screen and swap
+    PROFILE_CAPTURE,            // Readback and hand off, encoding runs on the workers
+    PROFILE_RELOAD,             // Frames where --watch reloaded something
+    PROFILE_WAIT,               // Frame pacer, taken out of frame and present
+    NO_OF_PROFILE_SECTIONS
+} ProfileSection;
+// --------------------
+
+typedef struct ProfileStat {
+    const char *name;
+    double start;               // GetTime() at ProfileBegin
+    double last;                // Seconds
+    double total;
+    double min;
+    double max;
+    int samples;
+} ProfileStat;
+
+ProfileStat profiler[NO_OF_PROFILE_SECTIONS] = {
+    [PROFILE_FRAME]   = { .name = "frame",   .min = DBL_MAX },
+    [PROFILE_INPUT]   = { .name = "input",   .min = DBL_MAX },
+    [PROFILE_UPDATE]  = { .name = "update",  .min = DBL_MAX },
+    [PROFILE_DRAW]    = { .name = "draw",    .min = DBL_MAX },
+    [PROFILE_PRESENT] = { .name = "present", .min = DBL_MAX },
+    [PROFILE_CAPTURE] = { .name = "capture", .min = DBL_MAX },
+    [PROFILE_RELOAD]  = { .name = "reload",  .min = DBL_MAX },
+    [PROFILE_WAIT]    = { .name = "wait",    .min = DBL_MAX },
+};
+
+void ProfileBegin(ProfileSection section) {
+    profiler[section].start = GetTime();
+}
+
+double ProfileEnd(ProfileSection section) {
+    ProfileStat *stat = &profiler[section];
+    stat->last = GetTime() - stat->start;
+    stat->total += stat->last;
+    if (stat->last < stat->min) stat->min = stat->last;
+    if (stat->last > stat->max) stat->max = stat->last;
+    ++stat->samples;
+    return stat->last;
+}
+
+// Time spent in a nested section that should not count towards this one
+void ProfileExclude(ProfileSection section, double seconds) {
+    profiler[section].start += seconds;
+}
+
+void ProfileReset() {
+    for (int i = 0; i < NO_OF_PROFILE_SECTIONS; ++i) {
+        ProfileStat *stat = &profiler[i];
+        stat->last = stat->total = stat->max = 0.0;
+        stat->min = DBL_MAX;
+        stat->samples = 0;
+    }
+}
+
+void ProfilePrint() {
+    printf("%-14s %10s %10s %10s %8s\n", "section", "avg ms", "min ms", "max ms", "samples");
+    for (int i = 0; i < NO_OF_PROFILE_SECTIONS; ++i) {
+        ProfileStat *stat = &profiler[i];
+        if (stat->samples == 0) continue;
+        printf("%-14s %10.3f %10.3f %10.3f %8d\n",
+                stat->name,
+                stat->total / stat->samples * 1000.0,
+                stat->min * 1000.0,
+                stat->max * 1000.0,
+                stat->samples);
+    }
+}
+
+#endif // LEARN_COLORS_PROFILER_
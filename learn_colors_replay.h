@@ -0,0 +1,239 @@
+#ifndef LEARN_COLORS_REPLAY_
+#define LEARN_COLORS_REPLAY_
+
+#include "raylib.h"
+#include "learn_colors_touch.h"
+#include "learn_colors_pacer.h"
+#include "learn_colors_tuning.h"
+#include "presentation.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+// --------------------
+#define REPLAY_MAGIC 0x50524c4c     // "LLRP"
+#define REPLAY_VERSION 5
+#define REPLAY_FRAME_TIME (1.0f / 60.0f)
+// --------------------
+
+#define REPLAY_PRESSED  0x1
+#define REPLAY_DOWN     0x2
+#define REPLAY_RELEASED 0x4
+
+// Keys that change the game, not just how it looks
+#define REPLAY_DEAL     0x1         // R
+#define REPLAY_NEXT     0x2         // PAGE_DOWN
+#define REPLAY_PREVIOUS 0x4         // PAGE_UP
+
+typedef enum {
+    REPLAY_OFF = 0,
+    REPLAY_RECORD,
+    REPLAY_PLAY,
+} ReplayMode;
+
+// On disk, after the header each frame is a ReplayFrame followed by `count` ReplayPointers
+typedef struct ReplayFrame {
+    float x;                    // Hover position
+    float y;
+    unsigned int count;
+    unsigned int keys;          // REPLAY_DEAL | REPLAY_NEXT | REPLAY_PREVIOUS
+    unsigned int first;         // In memory only, index of the frame's first pointer
+} ReplayFrame;
+
+#define REPLAY_FRAME_SIZE (sizeof(float) * 2 + sizeof(unsigned int) * 2)     // On disk, without first
+
+typedef struct ReplayPointer {
+    int id;
+    float x;
+    float y;
+    unsigned int buttons;       // REPLAY_PRESSED | REPLAY_DOWN | REPLAY_RELEASED
+} ReplayPointer;
+
+typedef struct ReplayHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int seed;          // Passed to SetRandomSeed so cards and clouds match
+    unsigned int level;         // Level the session started on
+    unsigned int frameCount;
+    unsigned int config;        // ReplayConfig when recording started
+} ReplayHeader;
+
+typedef struct Replay {
+    ReplayMode mode;
+    unsigned int seed;
+    int level;
+    unsigned int config;
+    FILE *file;                 // REPLAY_RECORD
+    ReplayFrame *frames;        // REPLAY_PLAY, whole session in memory
+    ReplayPointer *pointers;
+    int frameCount;
+    int frame;
+    unsigned int keys;          // REPLAY_RECORD, written with this frame's pointers
+} Replay;
+
+Replay replay = { 0 };
+
+// FNV-1a of the tuning values and the presentation profile, both change how a replay plays out
+unsigned int ReplayConfig() {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < NO_OF_TUNINGS; ++i) {
+        unsigned char bytes[sizeof(float)];
+        memcpy(bytes, TuningValue(&tuning, i), sizeof(float));
+        for (size_t j = 0; j < sizeof(float); ++j) hash = (hash ^ bytes[j]) * 16777619u;
+    }
+    for (int i = 0; i < NO_OF_PRESENTATION_FLAGS; ++i) {
+        hash = (hash ^ *PresentationFlag(&presentation, i)) * 16777619u;
+    }
+    return hash;
+}
+
+bool ReplayRecord(const char *fileName, int level) {
+    replay.file = fopen(fileName, "wb");
+    if (replay.file == NULL) return false;
+
+    replay.mode = REPLAY_RECORD;
+    replay.seed = (unsigned int) time(NULL);
+    replay.level = level;
+    replay.frameCount = 0;
+    replay.config = ReplayConfig();
+
+    // frameCount is patched in ReplayClose
+    ReplayHeader header = { REPLAY_MAGIC, REPLAY_VERSION, replay.seed, (unsigned int) level, 0, replay.config };
+    fwrite(&header, sizeof(header), 1, replay.file);
+    return true;
+}
+
+bool ReplayLoad(const char *fileName) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    ReplayHeader header = { 0 };
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+        printf("%s: not a replay (version %d)\n", fileName, REPLAY_VERSION);
+        fclose(file);
+        return false;
+    }
+    if (header.level >= MAX_LEVELS) {
+        printf("%s: level %u, at most %d\n", fileName, header.level, MAX_LEVELS - 1);
+        fclose(file);
+        return false;
+    }
+
+    // frameCount comes from the file. Frames and pointers both take space on disk, so its size caps them.
+    long start = ftell(file);
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, start, SEEK_SET);
+    size_t bytes = size > start ? (size_t) (size - start) : 0;
+    if (header.frameCount > bytes / REPLAY_FRAME_SIZE) {
+        printf("%s: %u frames, only %u fit, truncated?\n", fileName, header.frameCount, (unsigned int) (bytes / REPLAY_FRAME_SIZE));
+        header.frameCount = (unsigned int) (bytes / REPLAY_FRAME_SIZE);
+    }
+    // At most MAX_POINTER_EVENTS per frame, sized for the worst case the file can hold then read frame by frame
+    size_t frames = header.frameCount > 0 ? header.frameCount : 1;
+    size_t pointers = MIN(MAX_POINTER_EVENTS * frames, bytes / sizeof(ReplayPointer) + 1);
+    replay.frames = malloc(sizeof(ReplayFrame) * frames);
+    replay.pointers = malloc(sizeof(ReplayPointer) * pointers);
+    if (replay.frames == NULL || replay.pointers == NULL) {
+        printf("%s: %u frames do not fit in memory\n", fileName, header.frameCount);
+        free(replay.frames);
+        free(replay.pointers);
+        replay = (Replay) { 0 };
+        fclose(file);
+        return false;
+    }
+    replay.frameCount = 0;
+
+    unsigned int first = 0;
+    for (unsigned int i = 0; i < header.frameCount; ++i) {
+        ReplayFrame *frame = &replay.frames[i];
+        if (fread(frame, REPLAY_FRAME_SIZE, 1, file) != 1 || frame->count > MAX_POINTER_EVENTS || first + frame->count > pointers) break;
+        if (fread(&replay.pointers[first], sizeof(ReplayPointer), frame->count, file) != frame->count) break;
+        frame->first = first;
+        first += frame->count;
+        ++replay.frameCount;
+    }
+    replay.seed = header.seed;
+    replay.level = (int) header.level;
+    replay.config = header.config;
+    replay.frame = 0;
+    replay.mode = REPLAY_PLAY;
+    fclose(file);
+    return true;
+}
+
+void ReplayRewind() {
+    replay.frame = 0;
+}
+
+bool ReplayFinished() {
+    return replay.mode == REPLAY_PLAY && replay.frame >= replay.frameCount;
+}
+
+// Takes the live keys, keeps them for this frame's record or swaps them for the replayed ones.
+// Call before ReplayPointers, which moves on to the next frame.
+unsigned int ReplayKeys(unsigned int live) {
+    if (replay.mode == REPLAY_RECORD) replay.keys = live;
+    else if (replay.mode == REPLAY_PLAY && replay.frame < replay.frameCount) return replay.frames[replay.frame].keys;
+    return live;
+}
+
+// Takes the live pointers, records them or swaps them for the replayed ones
+PointerFrame ReplayPointers(PointerFrame live) {
+    if (replay.mode == REPLAY_RECORD) {
+        ReplayFrame frame = { live.hover.x, live.hover.y, (unsigned int) live.count, replay.keys, 0 };
+        replay.keys = 0;
+        fwrite(&frame, REPLAY_FRAME_SIZE, 1, replay.file);
+        for (int i = 0; i < live.count; ++i) {
+            Pointer *pointer = &live.pointers[i];
+            ReplayPointer record = {
+                pointer->id,
+                pointer->position.x,
+                pointer->position.y,
+                (pointer->pressed ? REPLAY_PRESSED : 0) | (pointer->down ? REPLAY_DOWN : 0) | (pointer->released ? REPLAY_RELEASED : 0)
+            };
+            fwrite(&record, sizeof(record), 1, replay.file);
+        }
+        ++replay.frameCount;
+    } else if (replay.mode == REPLAY_PLAY && replay.frame < replay.frameCount) {
+        ReplayFrame *frame = &replay.frames[replay.frame++];
+        PointerFrame played = { .hover = { frame->x, frame->y }, .count = (int) frame->count };
+        for (unsigned int i = 0; i < frame->count; ++i) {
+            ReplayPointer *record = &replay.pointers[frame->first + i];
+            played.pointers[i] = (Pointer) {
+                .id = record->id,
+                .position = { record->x, record->y },
+                .pressed = record->buttons & REPLAY_PRESSED,
+                .down = record->buttons & REPLAY_DOWN,
+                .released = record->buttons & REPLAY_RELEASED
+            };
+        }
+        return played;
+    }
+    return live;
+}
+
+// Replayed sessions advance in fixed steps so every run draws the same frames, live ones by the pacer
+float GetReplayFrameTime() {
+    return replay.mode == REPLAY_PLAY ? REPLAY_FRAME_TIME : PacerFrameTime();
+}
+int GetReplayFPS() {
+    return replay.mode == REPLAY_PLAY ? (int) (1.0f / REPLAY_FRAME_TIME) : GetFPS();
+}
+
+void ReplayClose() {
+    if (replay.mode == REPLAY_RECORD) {
+        ReplayHeader header = { REPLAY_MAGIC, REPLAY_VERSION, replay.seed, (unsigned int) replay.level, (unsigned int) replay.frameCount, replay.config };
+        fseek(replay.file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, replay.file);
+        fclose(replay.file);
+        printf("%-14s: %d frames\n", "recorded", replay.frameCount);
+    }
+    free(replay.frames);
+    free(replay.pointers);
+    replay = (Replay) { 0 };
+}
+
+#endif // LEARN_COLORS_REPLAY_
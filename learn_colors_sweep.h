@@ -0,0 +1,86 @@
+#ifndef LEARN_COLORS_SWEEP_
+#define LEARN_COLORS_SWEEP_
+
+#include "presentation.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// --------------------
+#define NO_OF_COMBINATIONS (1 << NO_OF_FEATURES)
+#define SWEEP_WARMUP_FRAMES 10      // Skipped after each switch, textures and audio settle
+#define SWEEP_DEFAULT_FRAMES 120
+// --------------------
+
+// Runs the session once per combination of features and keeps the mean frame time of each
+typedef struct Sweep {
+    bool isRunning;
+    int framesPerRun;
+    int combination;            // Bit i set = featureInfo[i] enabled
+    int frame;
+    double total;               // Seconds, current combination
+    double frameTime[NO_OF_COMBINATIONS];
+} Sweep;
+
+Sweep sweep = { 0 };
+
+void SweepApply() {
+    for (int i = 0; i < NO_OF_FEATURES; ++i) {
+        *PresentationFlag(&presentation, i) = (sweep.combination >> i) & 1;
+    }
+    presentation.isOff = false;
+}
+
+void SweepBegin(int framesPerRun) {
+    sweep = (Sweep) {
+        .isRunning = true,
+        .framesPerRun = framesPerRun > 0 ? framesPerRun : SWEEP_DEFAULT_FRAMES,
+        .combination = 0
+    };
+    SweepApply();
+}
+
+// Call after each frame, returns true when the next combination starts and the session should restart
+bool SweepStep(double frameTime) {
+    if (!sweep.isRunning) return false;
+
+    if (sweep.frame++ >= SWEEP_WARMUP_FRAMES) {
+        sweep.total += frameTime;
+    }
+    if (sweep.frame < sweep.framesPerRun + SWEEP_WARMUP_FRAMES) return false;
+
+    sweep.frameTime[sweep.combination] = sweep.total / sweep.framesPerRun;
+    sweep.total = 0.0;
+    sweep.frame = 0;
+
+    if (++sweep.combination >= NO_OF_COMBINATIONS) {
+        sweep.isRunning = false;
+        return false;
+    }
+    SweepApply();
+    return true;
+}
+
+// Cost of a feature = mean frame time of every combination with it on, minus every combination with it off
+void SweepPrint() {
+    double none = sweep.frameTime[0];
+    double all = sweep.frameTime[NO_OF_COMBINATIONS - 1];
+
+    printf("%-14s: %d combinations x %d frames\n", "sweep", NO_OF_COMBINATIONS, sweep.framesPerRun);
+    printf("%-14s: %.3f ms\n", "all off", none * 1000.0);
+    printf("%-14s: %.3f ms\n", "all on", all * 1000.0);
+    printf("%-22s %10s %8s\n", "feature", "cost ms", "of all");
+
+    for (int i = 0; i < NO_OF_FEATURES; ++i) {
+        double on = 0.0;
+        double off = 0.0;
+        for (int c = 0; c < NO_OF_COMBINATIONS; ++c) {
+            if ((c >> i) & 1) on += sweep.frameTime[c];
+            else off += sweep.frameTime[c];
+        }
+        double cost = (on - off) / (NO_OF_COMBINATIONS / 2);
+        printf("%-22s %10.3f %7.1f%%\n", featureInfo[i].name, cost * 1000.0, all > 0.0 ? cost / all * 100.0 : 0.0);
+    }
+}
+
+#endif // LEARN_COLORS_SWEEP_
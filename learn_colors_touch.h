@@ -0,0 +1,148 @@
+#ifndef LEARN_COLORS_TOUCH_
+#define LEARN_COLORS_TOUCH_
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// --------------------
+#define MAX_POINTERS 10
+#define MAX_POINTER_EVENTS (2 * MAX_POINTERS)   // Every pointer down plus every one that lifted
+#define MOUSE_POINTER_ID 0          // raylib reports the mouse as touch 0 on desktop too
+#define GRID_CELL 64                // Pixels, game space
+#define GRID_COLUMNS 16             // 16 x 64 >= 960
+#define GRID_ROWS 10                // 10 x 64 >= 640
+// --------------------
+
+// One finger (or the mouse) for one frame, in game (virtual) coordinates
+typedef struct Pointer {
+    int id;
+    Vector2 position;
+    bool pressed;
+    bool down;
+    bool released;              // Up this frame, position is where it left
+} Pointer;
+
+typedef struct PointerFrame {
+    Vector2 hover;              // Cursor position, first pointer when touching
+    int count;
+    Pointer pointers[MAX_POINTER_EVENTS];
+} PointerFrame;
+
+// Which card each finger is holding
+typedef struct PointerDrag {
+    int id;
+    int card;
+} PointerDrag;
+
+// Bit i of a cell = card (or tray) i overlaps it, so a press tests only what is under it
+typedef struct HitGrid {
+    unsigned int cards[GRID_ROWS][GRID_COLUMNS];
+    unsigned int trays[GRID_ROWS][GRID_COLUMNS];
+} HitGrid;
+
+// Down pointers of the previous frame, pressed/released are derived from the difference
+PointerFrame previousPointers = { 0 };
+
+void HitGridClear(HitGrid *grid) {
+    memset(grid, 0, sizeof(HitGrid));
+}
+
+void HitGridAdd(unsigned int cells[GRID_ROWS][GRID_COLUMNS], Rectangle rect, int index) {
+    int x0 = Clamp(rect.x / GRID_CELL, 0, GRID_COLUMNS - 1);
+    int y0 = Clamp(rect.y / GRID_CELL, 0, GRID_ROWS - 1);
+    int x1 = Clamp((rect.x + rect.width) / GRID_CELL, 0, GRID_COLUMNS - 1);
+    int y1 = Clamp((rect.y + rect.height) / GRID_CELL, 0, GRID_ROWS - 1);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            cells[y][x] |= 1u << index;
+        }
+    }
+}
+
+unsigned int HitGridPoint(unsigned int cells[GRID_ROWS][GRID_COLUMNS], Vector2 point) {
+    int x = Clamp(point.x / GRID_CELL, 0, GRID_COLUMNS - 1);
+    int y = Clamp(point.y / GRID_CELL, 0, GRID_ROWS - 1);
+    return cells[y][x];
+}
+
+unsigned int HitGridRect(unsigned int cells[GRID_ROWS][GRID_COLUMNS], Rectangle rect) {
+    unsigned int mask = HitGridPoint(cells, (Vector2) { rect.x, rect.y })
+        | HitGridPoint(cells, (Vector2) { rect.x + rect.width, rect.y })
+        | HitGridPoint(cells, (Vector2) { rect.x, rect.y + rect.height })
+        | HitGridPoint(cells, (Vector2) { rect.x + rect.width, rect.y + rect.height });
+
+    // Rects larger than a cell can cover cells none of their corners are in
+    if (rect.width > GRID_CELL || rect.height > GRID_CELL) {
+        int x0 = Clamp(rect.x / GRID_CELL, 0, GRID_COLUMNS - 1);
+        int y0 = Clamp(rect.y / GRID_CELL, 0, GRID_ROWS - 1);
+        int x1 = Clamp((rect.x + rect.width) / GRID_CELL, 0, GRID_COLUMNS - 1);
+        int y1 = Clamp((rect.y + rect.height) / GRID_CELL, 0, GRID_ROWS - 1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                mask |= cells[y][x];
+            }
+        }
+    }
+    return mask;
+}
+
+// Screen to game space, clamped behind the game screen
+Vector2 toVirtual(Vector2 position, float scale, int screenW, int screenH, int gameW, int gameH) {
+    Vector2 virtual = {
+        (position.x - (screenW - (gameW * scale)) * 0.5f) / scale,
+        (position.y - (screenH - (gameH * scale)) * 0.5f) / scale
+    };
+    return Vector2Clamp(virtual, (Vector2) { 0, 0 }, (Vector2) { (float) gameW, (float) gameH });
+}
+
+// Every touch point, or the mouse when nothing touches, with edges against last frame
+PointerFrame ReadPointers(float scale, int screenW, int screenH, int gameW, int gameH) {
+    PointerFrame frame = { 0 };
+    frame.hover = toVirtual(GetMousePosition(), scale, screenW, screenH, gameW, gameH);
+
+    int touches = MIN(GetTouchPointCount(), MAX_POINTERS);
+    for (int i = 0; i < touches; ++i) {
+        frame.pointers[frame.count++] = (Pointer) {
+            .id = GetTouchPointId(i),
+            .position = toVirtual(GetTouchPosition(i), scale, screenW, screenH, gameW, gameH),
+            .down = true
+        };
+    }
+    if (touches == 0 && IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+        frame.pointers[frame.count++] = (Pointer) { .id = MOUSE_POINTER_ID, .position = frame.hover, .down = true };
+    }
+    if (frame.count > 0) frame.hover = frame.pointers[0].position;
+
+    // New ids were pressed this frame
+    for (int i = 0; i < frame.count; ++i) {
+        Pointer *pointer = &frame.pointers[i];
+        pointer->pressed = true;
+        for (int j = 0; j < previousPointers.count; ++j) {
+            if (previousPointers.pointers[j].id == pointer->id) pointer->pressed = false;
+        }
+    }
+    PointerFrame down = frame;
+
+    // Ids that disappeared were released where they were last seen, a full frame of new fingers still has room
+    for (int j = 0; j < previousPointers.count; ++j) {
+        bool isDown = false;
+        for (int i = 0; i < down.count; ++i) {
+            if (down.pointers[i].id == previousPointers.pointers[j].id) isDown = true;
+        }
+        if (!isDown) {
+            frame.pointers[frame.count++] = (Pointer) {
+                .id = previousPointers.pointers[j].id,
+                .position = previousPointers.pointers[j].position,
+                .released = true
+            };
+        }
+    }
+
+    previousPointers = down;
+    return frame;
+}
+
+#endif // LEARN_COLORS_TOUCH_
@@ -0,0 +1,80 @@
+#ifndef LEARN_COLORS_TUNING_
+#define LEARN_COLORS_TUNING_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// --------------------
+#define TUNING_FILE "resources/tuning.cfg"
+// --------------------
+
+// Feel of the game, read at startup and again on save with --watch
+typedef struct Tuning {
+    float shakeDuration;        // Seconds a tray shakes after a hit
+    float shakeIntensity;       // Pixels
+    float tweenDuration;        // Frames a card takes back to its slot, 0 = the level's tweenDuration
+    float starFrameSpeed;       // Star sheet frames per second
+} Tuning;
+
+typedef struct TuningInfo {
+    const char *name;
+    size_t offset;
+    float min;
+} TuningInfo;
+
+#define NO_OF_TUNINGS 4
+
+const TuningInfo tuningInfo[NO_OF_TUNINGS] = {
+    { "shakeDuration",  offsetof(Tuning, shakeDuration),  0.0f },
+    { "shakeIntensity", offsetof(Tuning, shakeIntensity), 0.0f },
+    { "tweenDuration",  offsetof(Tuning, tweenDuration),  0.0f },
+    { "starFrameSpeed", offsetof(Tuning, starFrameSpeed), 1.0f },   // Divides the frame rate
+};
+
+Tuning tuning = {
+    .shakeDuration = 0.10f,
+    .shakeIntensity = 1.0f,
+    .tweenDuration = 0.0f,
+    .starFrameSpeed = 10.0f
+};
+
+float *TuningValue(Tuning *t, int index) {
+    return (float *) ((char *) t + tuningInfo[index].offset);
+}
+
+// Same format as the presentation profile, `shakeIntensity = 2.5`. Keys left out keep their value.
+bool LoadTuning(const char *fileName) {
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return false;
+
+    char line[128];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        ++lineNumber;
+        char name[64];
+        float value;
+        if (line[0] == '#' || sscanf(line, " %63[^ =] = %f", name, &value) != 2) continue;
+
+        int index = 0;
+        while (index < NO_OF_TUNINGS && strcmp(tuningInfo[index].name, name) != 0) ++index;
+
+        if (index == NO_OF_TUNINGS) {
+            printf("%s:%d: unknown value %s\n", fileName, lineNumber, name);
+            continue;
+        }
+        *TuningValue(&tuning, index) = value < tuningInfo[index].min ? tuningInfo[index].min : value;
+    }
+
+    fclose(file);
+    return true;
+}
+
+void TuningPrint() {
+    for (int i = 0; i < NO_OF_TUNINGS; ++i) {
+        printf("%-14s: %.3f\n", tuningInfo[i].name, *TuningValue(&tuning, i));
+    }
+}
+
+#endif // LEARN_COLORS_TUNING_
@@ -1,11 +1,137 @@
+#ifndef PRESENTATION_H
+#define PRESENTATION_H
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
 // Presentation
-#define isDrawBackground true
-#define isPrarallaxBackground true
-#define isShowCursor true
-#define isDrawTray true
-#define isDrawCard true
-#define isTweenCard true
-#define isAnimateStars true
-#define isAudio true
-
-#define isOff false   // global flag to turn all examples off
+// Compile-time defaults, the runtime profile starts from these
+#define DEFAULT_DRAW_BACKGROUND true
+#define DEFAULT_PARALLAX_BACKGROUND true
+#define DEFAULT_SHOW_CURSOR true
+#define DEFAULT_DRAW_TRAY true
+#define DEFAULT_DRAW_CARD true
+#define DEFAULT_TWEEN_CARD true
+#define DEFAULT_ANIMATE_STARS true
+#define DEFAULT_AUDIO true
+
+#define DEFAULT_OFF false   // global flag to turn all examples off
+
+#define PRESENTATION_FILE "resources/presentation.cfg"
+
+typedef struct Presentation {
+    bool isDrawBackground;
+    bool isPrarallaxBackground;
+    bool isShowCursor;
+    bool isDrawTray;
+    bool isDrawCard;
+    bool isTweenCard;
+    bool isAnimateStars;
+    bool isAudio;
+    bool isOff;                 // global flag to turn all examples off
+} Presentation;
+
+// Every toggle except isOff, the sweep runs each combination of these
+typedef enum {
+    FEATURE_BACKGROUND = 0,
+    FEATURE_PARALLAX,
+    FEATURE_CURSOR,
+    FEATURE_TRAY,
+    FEATURE_CARD,
+    FEATURE_TWEEN,
+    FEATURE_STARS,
+    FEATURE_AUDIO,
+    NO_OF_FEATURES
+} Feature;
+
+#define FEATURE_OFF NO_OF_FEATURES
+#define NO_OF_PRESENTATION_FLAGS (NO_OF_FEATURES + 1)
+
+typedef struct FeatureInfo {
+    const char *name;           // Key used in the profile file
+    int key;                    // Hotkey that toggles it
+    size_t offset;              // Member inside Presentation
+} FeatureInfo;
+
+const FeatureInfo featureInfo[NO_OF_PRESENTATION_FLAGS] = {
+    { "isDrawBackground",       KEY_F1, offsetof(Presentation, isDrawBackground) },
+    { "isPrarallaxBackground",  KEY_F2, offsetof(Presentation, isPrarallaxBackground) },
+    { "isShowCursor",           KEY_F3, offsetof(Presentation, isShowCursor) },
+    { "isDrawTray",             KEY_F4, offsetof(Presentation, isDrawTray) },
+    { "isDrawCard",             KEY_F5, offsetof(Presentation, isDrawCard) },
+    { "isTweenCard",            KEY_F6, offsetof(Presentation, isTweenCard) },
+    { "isAnimateStars",         KEY_F7, offsetof(Presentation, isAnimateStars) },
+    { "isAudio",                KEY_F8, offsetof(Presentation, isAudio) },
+    { "isOff",                  KEY_F9, offsetof(Presentation, isOff) },
+};
+
+// What was asked for, by the profile file or hotkeys
+Presentation presentation = {
+    .isDrawBackground = DEFAULT_DRAW_BACKGROUND,
+    .isPrarallaxBackground = DEFAULT_PARALLAX_BACKGROUND,
+    .isShowCursor = DEFAULT_SHOW_CURSOR,
+    .isDrawTray = DEFAULT_DRAW_TRAY,
+    .isDrawCard = DEFAULT_DRAW_CARD,
+    .isTweenCard = DEFAULT_TWEEN_CARD,
+    .isAnimateStars = DEFAULT_ANIMATE_STARS,
+    .isAudio = DEFAULT_AUDIO,
+    .isOff = DEFAULT_OFF
+};
+
+// What actually runs this frame, isOff already folded in
+Presentation features = { 0 };
+
+bool *PresentationFlag(Presentation *p, int index) {
+    return (bool *) ((char *) p + featureInfo[index].offset);
+}
+
+// Resolve once at the start of a frame, the hot loop only reads `features`
+void ResolvePresentation() {
+    features = presentation;
+    if (features.isOff) {
+        features = (Presentation) { .isOff = true };
+    }
+}
+
+// Lines look like `isDrawTray = false`, '#' starts a comment
+bool LoadPresentation(const char *fileName) {
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return false;
+
+    char line[128];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        ++lineNumber;
+        char name[64];
+        char value[16];
+        if (line[0] == '#' || sscanf(line, " %63[^ =] = %15s", name, value) != 2) continue;
+
+        int index = 0;
+        while (index < NO_OF_PRESENTATION_FLAGS && strcmp(featureInfo[index].name, name) != 0) ++index;
+
+        if (index == NO_OF_PRESENTATION_FLAGS) {
+            printf("%s:%d: unknown flag %s\n", fileName, lineNumber, name);
+            continue;
+        }
+        *PresentationFlag(&presentation, index) = (strcmp(value, "true") == 0 || strcmp(value, "1") == 0);
+    }
+
+    fclose(file);
+    return true;
+}
+
+void HandlePresentationKeys() {
+    for (int i = 0; i < NO_OF_PRESENTATION_FLAGS; ++i) {
+        if (IsKeyPressed(featureInfo[i].key)) {
+            bool *flag = PresentationFlag(&presentation, i);
+            *flag = !*flag;
+            printf("%-22s: %s\n", featureInfo[i].name, *flag ? "true" : "false");
+        }
+    }
+}
+
+#endif // PRESENTATION_H